@@ -0,0 +1,138 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <functional>
+#include <new>
+#include <cstdlib>
+#include <atomic>
+#include <verbly.h>
+
+/**
+ * Counts the heap allocations made while building, copying, and normalizing
+ * representative filters. Every allocation in the process goes through the
+ * replaced global operator new below, so the counts include the filters'
+ * nodes and everything they hold, such as strings and fields.
+ */
+
+namespace {
+
+  std::atomic<size_t> allocations(0);
+
+};
+
+void* operator new(std::size_t size)
+{
+  allocations++;
+
+  if (void* ptr = std::malloc(size ? size : 1))
+  {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+using namespace verbly;
+
+// A filter of the kind a bot uses to pick a word: a common noun with a
+// simple two-syllable base form, under a particular hypernym.
+filter buildWordFilter()
+{
+  return (word::forms(inflection::base) %= (
+      (form::complexity == 1)
+      && (form::proper == false)
+      && (form::pronunciations %= (pronunciation::numOfSyllables == 2))))
+    && (word::notions %= (
+      (notion::partOfSpeech == part_of_speech::noun)
+      && (notion::fullHypernyms %= (notion::wnid == 100001740))))
+    && (word::tagCount >= 1);
+}
+
+// A filter built up one condition at a time, the way a caller assembles
+// optional constraints.
+filter buildIncrementalFilter()
+{
+  filter result;
+
+  for (int i = 0; i < 16; i++)
+  {
+    result &= (word::tagCount != i);
+  }
+
+  result &= (word::forms(inflection::plural) %= (form::length <= 8));
+  result |= (word::notions %= (notion::numOfImages >= 10));
+
+  return result;
+}
+
+void measure(const std::string& name, std::function<void()> work)
+{
+  const size_t iterations = 1000;
+
+  size_t before = allocations;
+
+  for (size_t i = 0; i < iterations; i++)
+  {
+    work();
+  }
+
+  size_t total = allocations - before;
+
+  std::cout << std::left << std::setw(32) << name
+    << std::right << std::setw(10) << (total / iterations)
+    << " allocations" << std::endl;
+}
+
+int main()
+{
+  filter wordFilter = buildWordFilter();
+  filter incrementalFilter = buildIncrementalFilter();
+  filter normalized = wordFilter.normalize(object::word);
+
+  measure("build word filter", [] () {
+    filter result = buildWordFilter();
+  });
+
+  measure("build incremental filter", [] () {
+    filter result = buildIncrementalFilter();
+  });
+
+  measure("copy word filter", [&] () {
+    filter copy = wordFilter;
+  });
+
+  measure("normalize word filter", [&] () {
+    filter result = wordFilter.normalize(object::word);
+  });
+
+  measure("normalize incremental filter", [&] () {
+    filter result = incrementalFilter.normalize(object::word);
+  });
+
+  measure("compact normalized filter", [&] () {
+    filter result = normalized.compact();
+  });
+
+  measure("join condition of word filter", [&] () {
+    for (const filter& child : normalized)
+    {
+      if (child.getType() == filter::type::singleton
+        && child.getComparison() == filter::comparison::matches)
+      {
+        filter condition = child.getJoinCondition();
+      }
+    }
+  });
+
+  return 0;
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <hkutil/database.h>
+#include <verbly.h>
+#include "statement.h"
+
+/**
+ * Measures how many rows per second each object type is read at. Every row of
+ * the object's table is selected, in a fixed order, and hydrated into objects
+ * straight from the cursor. For comparison, the same query is also read into
+ * hatkirby::row vectors without constructing any objects, which is the step
+ * that objects used to be constructed from.
+ */
+
+using namespace verbly;
+
+template <typename Object>
+void measure(
+  const std::string& name,
+  const database& db,
+  hatkirby::database& rows,
+  query<Object> (database::*getQuery)(filter, order, int) const,
+  const field& sortField)
+{
+  using clock = std::chrono::steady_clock;
+
+  auto start = clock::now();
+
+  size_t count = (db.*getQuery)({}, sortField, -1).all().size();
+
+  std::chrono::duration<double> hydrated = clock::now() - start;
+
+  statement stmt(Object::objectType, {});
+
+  std::string queryString = stmt.getQueryString(Object::select, sortField, -1);
+
+  start = clock::now();
+
+  rows.queryAll(queryString, stmt.getBindings());
+
+  std::chrono::duration<double> rowsOnly = clock::now() - start;
+
+  std::cout << std::left << std::setw(16) << name
+    << std::right << std::setw(10) << count << " rows"
+    << std::setw(12) << static_cast<long long>(count / hydrated.count())
+    << " objects/s"
+    << std::setw(12) << static_cast<long long>(count / rowsOnly.count())
+    << " hkutil rows/s" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc != 2)
+  {
+    std::cout << "usage: hydration datafile" << std::endl;
+
+    return 1;
+  }
+
+  database db(argv[1]);
+  hatkirby::database rows(argv[1], hatkirby::dbmode::read);
+
+  measure<notion>("notion", db, rows, &database::notions, notion::id);
+  measure<word>("word", db, rows, &database::words, word::id);
+  measure<form>("form", db, rows, &database::forms, form::id);
+
+  measure<pronunciation>(
+    "pronunciation",
+    db,
+    rows,
+    &database::pronunciations,
+    pronunciation::id);
+
+  measure<frame>("frame", db, rows, &database::frames, frame::id);
+  measure<part>("part", db, rows, &database::parts, part::index);
+
+  return 0;
+}
@@ -0,0 +1,309 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <sqlite3.h>
+#include <verbly.h>
+#include "statement.h"
+
+/**
+ * Compares the query plans and running times of typical word filters, as
+ * compiled by the statement compiler now and as compiled before relationship
+ * filters became semi-join subqueries. The earlier queries were produced by the
+ * compiler at the parent of the commit that made that change, with their
+ * values inlined, and the current queries are compiled the same way, with
+ * the datafile's statistics. Both are run against the given datafile, and the
+ * number of rows each returns is printed so that they can be checked against
+ * each other.
+ */
+
+using namespace verbly;
+
+struct workload {
+  std::string name;
+  filter queryFilter;
+  const char* joinQuery;
+};
+
+const std::vector<workload>& getWorkloads()
+{
+  static const std::vector<workload> workloads = {
+    {
+      "two-syllable base form",
+      word::forms(inflection::base) %=
+        (form::pronunciations %= (pronunciation::numOfSyllables == 2)),
+      "SELECT words_0.word_id, words_0.notion_id, words_0.lemma_id, "
+      "words_0.tag_count, words_0.position, words_0.group_id "
+      "FROM words AS words_0 "
+      "INNER JOIN lemmas_forms AS lemmas_forms_1 ON "
+      "lemmas_forms_1.lemma_id = words_0.lemma_id "
+      "INNER JOIN forms AS forms_1 ON forms_1.form_id = "
+      "lemmas_forms_1.form_id "
+      "INNER JOIN forms_pronunciations AS forms_pronunciations_2 ON "
+      "forms_pronunciations_2.form_id = forms_1.form_id "
+      "INNER JOIN pronunciations AS pronunciations_2 ON "
+      "pronunciations_2.pronunciation_id = "
+      "forms_pronunciations_2.pronunciation_id "
+      "WHERE pronunciations_2.syllables = 2 "
+      "AND lemmas_forms_1.category = 0 "
+      "GROUP BY words_0.word_id "
+      "ORDER BY words_0.word_id"
+    },
+    {
+      "no two-syllable base form",
+      !(word::forms(inflection::base) %=
+        (form::pronunciations %= (pronunciation::numOfSyllables == 2))),
+      "WITH RECURSIVE lemmas_forms_tree_0 AS (SELECT lemmas_forms_3.* "
+      "FROM lemmas_forms AS lemmas_forms_3 "
+      "INNER JOIN forms_pronunciations AS forms_pronunciations_2 ON "
+      "forms_pronunciations_2.form_id = forms_1.form_id "
+      "INNER JOIN pronunciations AS pronunciations_2 ON "
+      "pronunciations_2.pronunciation_id = "
+      "forms_pronunciations_2.pronunciation_id "
+      "INNER JOIN forms AS forms_1 ON forms_1.form_id = "
+      "lemmas_forms_3.form_id "
+      "WHERE pronunciations_2.syllables = 2 "
+      "AND lemmas_forms_3.category = 0) "
+      "SELECT words_0.word_id, words_0.notion_id, words_0.lemma_id, "
+      "words_0.tag_count, words_0.position, words_0.group_id "
+      "FROM words AS words_0 "
+      "LEFT JOIN lemmas_forms_tree_0 AS lemmas_forms_tree_0_1 ON "
+      "lemmas_forms_tree_0_1.lemma_id = words_0.lemma_id "
+      "WHERE lemmas_forms_tree_0_1.lemma_id IS NULL "
+      "GROUP BY words_0.word_id "
+      "ORDER BY words_0.word_id"
+    },
+    {
+      "has a plural form",
+      word::forms(inflection::plural),
+      "SELECT words_0.word_id, words_0.notion_id, words_0.lemma_id, "
+      "words_0.tag_count, words_0.position, words_0.group_id "
+      "FROM words AS words_0 "
+      "INNER JOIN lemmas_forms AS lemmas_forms_1 ON "
+      "lemmas_forms_1.lemma_id = words_0.lemma_id "
+      "INNER JOIN forms AS forms_1 ON forms_1.form_id = "
+      "lemmas_forms_1.form_id "
+      "WHERE lemmas_forms_1.category = 1 "
+      "GROUP BY words_0.word_id "
+      "ORDER BY words_0.word_id"
+    },
+    {
+      "hyponym of entity",
+      word::notions %= (notion::fullHypernyms %= (notion::wnid == 100001740)),
+      "WITH RECURSIVE hypernymy_tree_1 AS (SELECT notions_3.* "
+      "FROM notions AS notions_3 "
+      "WHERE notions_3.wnid = 100001740 "
+      "UNION SELECT l.* "
+      "FROM hypernymy_tree_1 AS t "
+      "INNER JOIN hypernymy AS j ON t.notion_id = j.hypernym_id "
+      "INNER JOIN notions AS l ON j.hyponym_id = l.notion_id) "
+      "SELECT words_0.word_id, words_0.notion_id, words_0.lemma_id, "
+      "words_0.tag_count, words_0.position, words_0.group_id "
+      "FROM words AS words_0 "
+      "INNER JOIN notions AS notions_1 ON notions_1.notion_id = "
+      "words_0.notion_id "
+      "INNER JOIN hypernymy_tree_1 AS hypernymy_tree_1_2 ON "
+      "hypernymy_tree_1_2.notion_id = notions_1.notion_id "
+      "GROUP BY words_0.word_id "
+      "ORDER BY words_0.word_id"
+    },
+    {
+      "rhymes with cat",
+      word::forms(inflection::base) %=
+        (form::pronunciations %=
+          (pronunciation::rhymes %=
+            (pronunciation::forms %= (form::text == "cat")))),
+      "SELECT words_0.word_id, words_0.notion_id, words_0.lemma_id, "
+      "words_0.tag_count, words_0.position, words_0.group_id "
+      "FROM words AS words_0 "
+      "INNER JOIN lemmas_forms AS lemmas_forms_1 ON "
+      "lemmas_forms_1.lemma_id = words_0.lemma_id "
+      "INNER JOIN forms AS forms_1 ON forms_1.form_id = "
+      "lemmas_forms_1.form_id "
+      "INNER JOIN forms_pronunciations AS forms_pronunciations_2 ON "
+      "forms_pronunciations_2.form_id = forms_1.form_id "
+      "INNER JOIN pronunciations AS pronunciations_2 ON "
+      "pronunciations_2.pronunciation_id = "
+      "forms_pronunciations_2.pronunciation_id "
+      "INNER JOIN pronunciations AS pronunciations_3 ON "
+      "pronunciations_3.rhyme = pronunciations_2.rhyme "
+      "INNER JOIN forms_pronunciations AS forms_pronunciations_4 ON "
+      "forms_pronunciations_4.pronunciation_id = "
+      "pronunciations_3.pronunciation_id "
+      "INNER JOIN forms AS forms_4 ON forms_4.form_id = "
+      "forms_pronunciations_4.form_id "
+      "WHERE pronunciations_3.prerhyme != pronunciations_2.prerhyme "
+      "AND forms_4.form = \"cat\" "
+      "AND lemmas_forms_1.category = 0 "
+      "GROUP BY words_0.word_id "
+      "ORDER BY words_0.word_id"
+    },
+    {
+      "antonym of good",
+      word::antonyms %=
+        (word::forms(inflection::base) %= (form::text == "good")),
+      "SELECT words_0.word_id, words_0.notion_id, words_0.lemma_id, "
+      "words_0.tag_count, words_0.position, words_0.group_id "
+      "FROM words AS words_0 "
+      "INNER JOIN antonymy AS antonymy_1 ON antonymy_1.antonym_2_id = "
+      "words_0.word_id "
+      "INNER JOIN words AS words_1 ON words_1.word_id = "
+      "antonymy_1.antonym_1_id "
+      "INNER JOIN lemmas_forms AS lemmas_forms_2 ON "
+      "lemmas_forms_2.lemma_id = words_1.lemma_id "
+      "INNER JOIN forms AS forms_2 ON forms_2.form_id = "
+      "lemmas_forms_2.form_id "
+      "WHERE forms_2.form = \"good\" "
+      "AND lemmas_forms_2.category = 0 "
+      "GROUP BY words_0.word_id "
+      "ORDER BY words_0.word_id"
+    },
+    {
+      "verb with frames",
+      (notion::partOfSpeech == part_of_speech::verb) && word::frames,
+      "SELECT words_0.word_id, words_0.notion_id, words_0.lemma_id, "
+      "words_0.tag_count, words_0.position, words_0.group_id "
+      "FROM words AS words_0 "
+      "INNER JOIN frames AS frames_1 ON frames_1.group_id = "
+      "words_0.group_id "
+      "INNER JOIN notions AS notions_2 ON notions_2.notion_id = "
+      "words_0.notion_id "
+      "WHERE notions_2.part_of_speech = 3 "
+      "GROUP BY words_0.word_id "
+      "ORDER BY words_0.word_id"
+    },
+    {
+      "simple noun",
+      (notion::partOfSpeech == part_of_speech::noun)
+        && (word::forms(inflection::base) %=
+          ((form::complexity == 1) && (form::proper == false))),
+      "SELECT words_0.word_id, words_0.notion_id, words_0.lemma_id, "
+      "words_0.tag_count, words_0.position, words_0.group_id "
+      "FROM words AS words_0 "
+      "INNER JOIN lemmas_forms AS lemmas_forms_1 ON "
+      "lemmas_forms_1.lemma_id = words_0.lemma_id "
+      "INNER JOIN forms AS forms_1 ON forms_1.form_id = "
+      "lemmas_forms_1.form_id "
+      "INNER JOIN notions AS notions_2 ON notions_2.notion_id = "
+      "words_0.notion_id "
+      "WHERE forms_1.complexity = 1 "
+      "AND forms_1.proper = 0 "
+      "AND lemmas_forms_1.category = 0 "
+      "AND notions_2.part_of_speech = 0 "
+      "GROUP BY words_0.word_id "
+      "ORDER BY words_0.word_id"
+    }
+  };
+
+  return workloads;
+}
+
+void printPlan(sqlite3* ppdb, const std::string& query)
+{
+  std::string explain = "EXPLAIN QUERY PLAN " + query;
+
+  sqlite3_stmt* ppstmt;
+  if (sqlite3_prepare_v2(ppdb, explain.c_str(), -1, &ppstmt, nullptr)
+    != SQLITE_OK)
+  {
+    std::cout << "    error: " << sqlite3_errmsg(ppdb) << std::endl;
+
+    return;
+  }
+
+  // Each step of the plan names its parent, so it is indented one level
+  // deeper than the parent.
+  std::map<int, int> depths;
+
+  while (sqlite3_step(ppstmt) == SQLITE_ROW)
+  {
+    int id = sqlite3_column_int(ppstmt, 0);
+    int parent = sqlite3_column_int(ppstmt, 1);
+
+    int depth = depths.count(parent) ? (depths.at(parent) + 1) : 0;
+    depths[id] = depth;
+
+    std::cout << "    " << std::string(depth * 2, ' ')
+      << reinterpret_cast<const char*>(sqlite3_column_text(ppstmt, 3))
+      << std::endl;
+  }
+
+  sqlite3_finalize(ppstmt);
+}
+
+void timeQuery(sqlite3* ppdb, const std::string& query)
+{
+  const int repetitions = 5;
+
+  size_t rows = 0;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (int i = 0; i < repetitions; i++)
+  {
+    sqlite3_stmt* ppstmt;
+    if (sqlite3_prepare_v2(ppdb, query.c_str(), -1, &ppstmt, nullptr)
+      != SQLITE_OK)
+    {
+      return;
+    }
+
+    rows = 0;
+    while (sqlite3_step(ppstmt) == SQLITE_ROW)
+    {
+      rows++;
+    }
+
+    sqlite3_finalize(ppstmt);
+  }
+
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  std::cout << "    " << rows << " rows, "
+    << (elapsed.count() / repetitions) << " ms" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc != 2)
+  {
+    std::cout << "usage: query_plans datafile" << std::endl;
+
+    return 1;
+  }
+
+  database db(argv[1]);
+
+  sqlite3* ppdb;
+  if (sqlite3_open_v2(argv[1], &ppdb, SQLITE_OPEN_READONLY, nullptr)
+    != SQLITE_OK)
+  {
+    std::cout << "could not open " << argv[1] << std::endl;
+
+    return 1;
+  }
+
+  for (const workload& w : getWorkloads())
+  {
+    statement stmt(object::word, w.queryFilter, &db.getStatistics());
+
+    std::string semiJoinQuery =
+      stmt.getQueryString(word::select, order(word::id), -1, true);
+
+    std::cout << "== " << w.name << std::endl;
+
+    std::cout << "  JOIN and GROUP BY:" << std::endl;
+    printPlan(ppdb, w.joinQuery);
+    timeQuery(ppdb, w.joinQuery);
+
+    std::cout << "  semi-join:" << std::endl;
+    printPlan(ppdb, semiJoinQuery);
+    timeQuery(ppdb, semiJoinQuery);
+  }
+
+  sqlite3_close(ppdb);
+
+  return 0;
+}
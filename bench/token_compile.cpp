@@ -0,0 +1,133 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <verbly.h>
+
+/**
+ * Measures how many times per second deep utterances can be compiled. The
+ * utterances are nested several levels deep and mix literals with the
+ * transforms that affect compilation: separators, punctuation, indefinite
+ * articles, capitalization and quotes. Each one is compiled into a new string,
+ * into a buffer that is reused across calls, and through a token_tree.
+ */
+
+using namespace verbly;
+
+// Builds an utterance with the given number of children at each level, down to
+// the given depth. Each level wraps its children in a different transform.
+token buildUtterance(int depth, int width)
+{
+  static const char* nouns[] = {"apple", "dog", "umbrella", "hat", "idea"};
+
+  if (depth == 0)
+  {
+    token result;
+
+    for (int i = 0; i < width; i++)
+    {
+      result << token::indefiniteArticle(nouns[i % 5]);
+    }
+
+    return result;
+  }
+
+  token result;
+
+  for (int i = 0; i < width; i++)
+  {
+    token child = buildUtterance(depth - 1, width);
+
+    switch ((depth + i) % 4)
+    {
+      case 0:
+      {
+        result << token::separator(", ", std::move(child));
+
+        break;
+      }
+
+      case 1:
+      {
+        result << token::punctuation(".", std::move(child));
+
+        break;
+      }
+
+      case 2:
+      {
+        result << token::capitalize(
+          token::casing::title_case,
+          std::move(child));
+
+        break;
+      }
+
+      case 3:
+      {
+        result << token::quote("\"", "\"", std::move(child));
+
+        break;
+      }
+    }
+  }
+
+  return token::capitalize(token::casing::capitalize, std::move(result));
+}
+
+void measure(
+  const std::string& name,
+  size_t outputSize,
+  std::function<void()> compile)
+{
+  const size_t iterations = 2000;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < iterations; i++)
+  {
+    compile();
+  }
+
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  std::cout << std::left << std::setw(24) << name
+    << std::right << std::setw(10)
+    << static_cast<long long>(iterations / elapsed.count())
+    << " compiles/s" << std::setw(10)
+    << static_cast<long long>(iterations * outputSize / elapsed.count()
+      / (1024 * 1024))
+    << " MiB/s" << std::endl;
+}
+
+int main()
+{
+  for (int depth : {2, 4})
+  {
+    token utterance = buildUtterance(depth, 4);
+    token_tree tree(utterance);
+
+    size_t outputSize = utterance.compile().size();
+
+    std::cout << "depth " << depth << ", " << tree.size() << " nodes, "
+      << outputSize << " characters" << std::endl;
+
+    measure("  new string", outputSize, [&] () {
+      std::string result = utterance.compile();
+    });
+
+    std::string buffer;
+
+    measure("  reused buffer", outputSize, [&] () {
+      utterance.compile(buffer);
+    });
+
+    measure("  token_tree", outputSize, [&] () {
+      tree.compile(buffer);
+    });
+  }
+
+  return 0;
+}
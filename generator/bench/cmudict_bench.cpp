@@ -0,0 +1,144 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <regex>
+#include <chrono>
+#include <functional>
+#include <hkutil/string.h>
+#include "../cmudict_entry.h"
+#include "../pronunciation.h"
+
+/**
+ * Times reading the entries of a CMUDICT file with findCmudictEntry, against
+ * the std::regex pattern that the pronunciation reader used before it. Each
+ * path extracts the word and phonemes of every entry, and constructs a
+ * pronunciation from the phonemes, which is where the rhyme, stress and
+ * syllables are worked out. The number of entries each one accepts is printed
+ * alongside its throughput so that the two can be checked against each other.
+ */
+
+using verbly::generator::findCmudictEntry;
+using verbly::generator::pronunciation;
+
+struct result {
+  size_t entries = 0;
+  long long checksum = 0;
+};
+
+void report(
+  const std::string& name,
+  const std::vector<std::string>& lines,
+  std::function<result()> parse)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  result r = parse();
+
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  std::cout << name << ": " << r.entries << " entries, checksum "
+    << r.checksum << ", " << elapsed.count() << "s, "
+    << static_cast<long long>(lines.size() / elapsed.count())
+    << " lines/s" << std::endl;
+}
+
+void addEntry(result& r, std::string word, std::string phonemes)
+{
+  std::string canonical = hatkirby::lowercase(std::move(word));
+  pronunciation p(std::move(phonemes));
+
+  r.entries++;
+  r.checksum += canonical.size() + p.getSyllables() + p.getStress().size();
+
+  if (p.hasRhyme())
+  {
+    r.checksum += p.getRhymePhonemes().size() + p.getPrerhyme().size();
+  }
+}
+
+result parseWithRegex(const std::vector<std::string>& lines, bool hoisted)
+{
+  const char* pattern = "([A-Z][^ \\(]*)(?:\\(\\d+\\))?  ([A-Z 0-9]+)";
+
+  std::regex shared(pattern);
+  result r;
+
+  for (const std::string& line : lines)
+  {
+    // The pronunciation reader built its pattern once for every line.
+    std::regex phoneme = hoisted ? shared : std::regex(pattern);
+
+    std::smatch phoneme_data;
+    if (!std::regex_search(line, phoneme_data, phoneme))
+    {
+      continue;
+    }
+
+    addEntry(r, phoneme_data[1], phoneme_data[2]);
+  }
+
+  return r;
+}
+
+result parseWithMatcher(const std::vector<std::string>& lines)
+{
+  result r;
+
+  for (const std::string& line : lines)
+  {
+    std::string_view word;
+    std::string_view phonemes;
+    if (!findCmudictEntry(line, word, phonemes))
+    {
+      continue;
+    }
+
+    addEntry(r, std::string(word), std::string(phonemes));
+  }
+
+  return r;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc != 2)
+  {
+    std::cout << "usage: cmudict_bench cmudict-0.7b" << std::endl;
+
+    return 1;
+  }
+
+  std::ifstream file(argv[1]);
+  if (!file)
+  {
+    std::cout << "Could not open " << argv[1] << std::endl;
+
+    return 1;
+  }
+
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line))
+  {
+    lines.push_back(std::move(line));
+  }
+
+  std::cout << lines.size() << " lines" << std::endl;
+
+  report("regex, built per line", lines, [&] () {
+    return parseWithRegex(lines, false);
+  });
+
+  report("regex, built once", lines, [&] () {
+    return parseWithRegex(lines, true);
+  });
+
+  report("findCmudictEntry", lines, [&] () {
+    return parseWithMatcher(lines);
+  });
+
+  return 0;
+}
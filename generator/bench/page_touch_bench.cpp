@@ -0,0 +1,171 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <sqlite3.h>
+
+/**
+ * Counts how many pages of a datafile are read to hydrate a word. A fixed
+ * sample of words is hydrated the way the library does it: the word's row,
+ * then the forms of its lemma, then the pronunciations of those forms. The
+ * page cache is kept small so that a page is only found in it when it was
+ * read for the same word or a recent one, and the number of cache misses per
+ * word shows how well the datafile's layout keeps a word's rows together.
+ */
+
+const char* wordQuery =
+  "SELECT word_id, notion_id, lemma_id, tag_count, position, group_id "
+  "FROM words WHERE word_id = ?";
+
+const char* formsQuery =
+  "SELECT forms.form_id, forms.form, forms.complexity, forms.proper, "
+  "forms.length FROM lemmas_forms "
+  "INNER JOIN forms ON forms.form_id = lemmas_forms.form_id "
+  "WHERE lemmas_forms.lemma_id IN "
+  "(SELECT lemma_id FROM words WHERE word_id = ?) "
+  "ORDER BY forms.form_id";
+
+const char* pronunciationsQuery =
+  "SELECT pronunciations.* FROM pronunciations "
+  "WHERE pronunciation_id IN "
+  "(SELECT forms_pronunciations.pronunciation_id FROM forms_pronunciations "
+  "INNER JOIN lemmas_forms "
+  "ON lemmas_forms.form_id = forms_pronunciations.form_id "
+  "WHERE lemmas_forms.lemma_id IN "
+  "(SELECT lemma_id FROM words WHERE word_id = ?)) "
+  "ORDER BY pronunciation_id";
+
+void check(sqlite3* ppdb, int result)
+{
+  if (result != SQLITE_OK)
+  {
+    throw std::runtime_error(sqlite3_errmsg(ppdb));
+  }
+}
+
+int queryInteger(sqlite3* ppdb, const char* query)
+{
+  sqlite3_stmt* ppstmt;
+  check(ppdb, sqlite3_prepare_v2(ppdb, query, -1, &ppstmt, NULL));
+
+  int result = 0;
+  if (sqlite3_step(ppstmt) == SQLITE_ROW)
+  {
+    result = sqlite3_column_int(ppstmt, 0);
+  }
+
+  sqlite3_finalize(ppstmt);
+
+  return result;
+}
+
+void runQuery(sqlite3* ppdb, const char* query, int wordId)
+{
+  sqlite3_stmt* ppstmt;
+  check(ppdb, sqlite3_prepare_v2(ppdb, query, -1, &ppstmt, NULL));
+  check(ppdb, sqlite3_bind_int(ppstmt, 1, wordId));
+
+  while (sqlite3_step(ppstmt) == SQLITE_ROW)
+  {
+    for (int i = 0; i < sqlite3_column_count(ppstmt); i++)
+    {
+      sqlite3_column_text(ppstmt, i);
+    }
+  }
+
+  sqlite3_finalize(ppstmt);
+}
+
+int main(int argc, char** argv)
+{
+  if ((argc != 2) && (argc != 3))
+  {
+    std::cout << "usage: page_touch_bench datafile [cache pages]" << std::endl;
+
+    return 1;
+  }
+
+  int cachePages = (argc == 3) ? std::stoi(argv[2]) : 10;
+  const size_t sampleSize = 2000;
+
+  sqlite3* ppdb;
+  if (sqlite3_open_v2(argv[1], &ppdb, SQLITE_OPEN_READONLY, NULL)
+    != SQLITE_OK)
+  {
+    std::cout << "Could not open " << argv[1] << std::endl;
+
+    return 1;
+  }
+
+  check(ppdb, sqlite3_exec(
+    ppdb,
+    ("PRAGMA cache_size = " + std::to_string(cachePages)).c_str(),
+    NULL,
+    NULL,
+    NULL));
+
+  std::vector<int> wordIds;
+
+  {
+    sqlite3_stmt* ppstmt;
+    check(ppdb, sqlite3_prepare_v2(
+      ppdb,
+      "SELECT word_id FROM words",
+      -1,
+      &ppstmt,
+      NULL));
+
+    while (sqlite3_step(ppstmt) == SQLITE_ROW)
+    {
+      wordIds.push_back(sqlite3_column_int(ppstmt, 0));
+    }
+
+    sqlite3_finalize(ppstmt);
+  }
+
+  // The sample is the same for every datafile with the same words, so that
+  // two layouts of the same data can be compared.
+  std::mt19937 rng(7);
+  std::shuffle(std::begin(wordIds), std::end(wordIds), rng);
+
+  if (wordIds.size() > sampleSize)
+  {
+    wordIds.resize(sampleSize);
+  }
+
+  int current;
+  int highwater;
+  sqlite3_db_status(ppdb, SQLITE_DBSTATUS_CACHE_MISS, &current, &highwater, 1);
+  sqlite3_db_status(ppdb, SQLITE_DBSTATUS_CACHE_HIT, &current, &highwater, 1);
+
+  for (int wordId : wordIds)
+  {
+    runQuery(ppdb, wordQuery, wordId);
+    runQuery(ppdb, formsQuery, wordId);
+    runQuery(ppdb, pronunciationsQuery, wordId);
+  }
+
+  int misses;
+  int hits;
+  sqlite3_db_status(ppdb, SQLITE_DBSTATUS_CACHE_MISS, &misses, &highwater, 0);
+  sqlite3_db_status(ppdb, SQLITE_DBSTATUS_CACHE_HIT, &hits, &highwater, 0);
+
+  int pageSize = queryInteger(ppdb, "PRAGMA page_size");
+  int pageCount = queryInteger(ppdb, "PRAGMA page_count");
+
+  sqlite3_close_v2(ppdb);
+
+  double words = wordIds.size();
+
+  std::cout << "page size " << pageSize << ", " << pageCount << " pages, "
+    << cachePages << " cached" << std::endl;
+  std::cout << "pages read per word: " << (misses / words) << std::endl;
+  std::cout << "cache hits per word: " << (hits / words) << std::endl;
+  std::cout << "bytes read per word: "
+    << static_cast<long long>(misses * static_cast<double>(pageSize) / words)
+    << std::endl;
+
+  return 0;
+}
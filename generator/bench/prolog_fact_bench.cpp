@@ -0,0 +1,148 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <regex>
+#include <chrono>
+#include <functional>
+#include "../prolog_fact.h"
+
+/**
+ * Times reading the facts of a wn_s.pl file with generator::prolog_fact,
+ * against the std::regex pattern that the synset reader used before it. Each
+ * path extracts the synset ID, word number, text, and tag count of every
+ * fact, and the number of facts each one accepts is printed alongside its
+ * throughput so that the two can be checked against each other.
+ */
+
+using verbly::generator::prolog_fact;
+
+struct result {
+  size_t facts = 0;
+  long long checksum = 0;
+};
+
+void report(
+  const std::string& name,
+  const std::vector<std::string>& lines,
+  std::function<result()> parse)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  result r = parse();
+
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  std::cout << name << ": " << r.facts << " facts, checksum " << r.checksum
+    << ", " << elapsed.count() << "s, "
+    << static_cast<long long>(lines.size() / elapsed.count())
+    << " lines/s" << std::endl;
+}
+
+result parseWithRegex(const std::vector<std::string>& lines, bool hoisted)
+{
+  const char* pattern =
+    "^s\\(([1234]\\d{8}),(\\d+),'(.+)',\\w,\\d+,(\\d+)\\)\\.$";
+
+  std::regex shared(pattern);
+  result r;
+
+  for (const std::string& line : lines)
+  {
+    // The synset reader built its pattern once for every line.
+    std::regex relation = hoisted ? shared : std::regex(pattern);
+
+    std::smatch relation_data;
+    if (!std::regex_search(line, relation_data, relation))
+    {
+      continue;
+    }
+
+    int synset_id = std::stoi(relation_data[1]);
+    int wnum = std::stoi(relation_data[2]);
+    std::string text = relation_data[3];
+    int tag_count = std::stoi(relation_data[4]);
+    size_t word_it;
+    while ((word_it = text.find("''")) != std::string::npos)
+    {
+      text.erase(word_it, 1);
+    }
+
+    r.facts++;
+    r.checksum += synset_id + wnum + text.size() + tag_count;
+  }
+
+  return r;
+}
+
+result parseWithFacts(const std::vector<std::string>& lines)
+{
+  prolog_fact fact;
+  result r;
+
+  for (const std::string& line : lines)
+  {
+    if (!fact.parse(line)
+      || (fact.getPredicate() != "s")
+      || (fact.getArgumentCount() != 6)
+      || !fact.isSynset(0, "1234")
+      || !fact.isInteger(1)
+      || fact.getRaw(2).empty()
+      || !fact.isInteger(5))
+    {
+      continue;
+    }
+
+    int synset_id = fact.getInteger(0);
+    int wnum = fact.getInteger(1);
+    std::string text = fact.getString(2);
+    int tag_count = fact.getInteger(5);
+
+    r.facts++;
+    r.checksum += synset_id + wnum + text.size() + tag_count;
+  }
+
+  return r;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc != 2)
+  {
+    std::cout << "usage: prolog_fact_bench wn_s.pl" << std::endl;
+
+    return 1;
+  }
+
+  std::ifstream file(argv[1]);
+  if (!file)
+  {
+    std::cout << "Could not open " << argv[1] << std::endl;
+
+    return 1;
+  }
+
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line))
+  {
+    lines.push_back(std::move(line));
+  }
+
+  std::cout << lines.size() << " lines" << std::endl;
+
+  report("regex, built per line", lines, [&] () {
+    return parseWithRegex(lines, false);
+  });
+
+  report("regex, built once", lines, [&] () {
+    return parseWithRegex(lines, true);
+  });
+
+  report("prolog_fact", lines, [&] () {
+    return parseWithFacts(lines);
+  });
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include "cmudict_entry.h"
+
+namespace verbly {
+  namespace generator {
+
+    namespace {
+
+      bool isUpper(char ch)
+      {
+        return (ch >= 'A') && (ch <= 'Z');
+      }
+
+      bool isDigit(char ch)
+      {
+        return (ch >= '0') && (ch <= '9');
+      }
+
+    };
+
+    bool findCmudictEntry(
+      std::string_view line,
+      std::string_view& word,
+      std::string_view& phonemes)
+    {
+      for (size_t start = 0; start < line.size(); start++)
+      {
+        if (!isUpper(line[start]))
+        {
+          continue;
+        }
+
+        size_t pos = line.find_first_of(" (", start + 1);
+        if (pos == std::string_view::npos)
+        {
+          continue;
+        }
+
+        size_t wordEnd = pos;
+
+        // Skips a variant number, like the (2) in "READ(2)".
+        if (line[pos] == '(')
+        {
+          size_t digits = pos + 1;
+          while ((digits < line.size()) && isDigit(line[digits]))
+          {
+            digits++;
+          }
+
+          if ((digits == pos + 1)
+            || (digits == line.size())
+            || (line[digits] != ')'))
+          {
+            continue;
+          }
+
+          pos = digits + 1;
+        }
+
+        if (line.compare(pos, 2, "  ") != 0)
+        {
+          continue;
+        }
+
+        pos += 2;
+
+        size_t end = pos;
+        while ((end < line.size())
+          && (isUpper(line[end]) || isDigit(line[end]) || (line[end] == ' ')))
+        {
+          end++;
+        }
+
+        if (end == pos)
+        {
+          continue;
+        }
+
+        word = line.substr(start, wordEnd - start);
+        phonemes = line.substr(pos, end - pos);
+
+        return true;
+      }
+
+      return false;
+    }
+
+  };
+};
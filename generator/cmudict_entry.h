@@ -0,0 +1,27 @@
+#ifndef CMUDICT_ENTRY_H_3B7E1D42
+#define CMUDICT_ENTRY_H_3B7E1D42
+
+#include <string_view>
+
+namespace verbly {
+  namespace generator {
+
+    /**
+     * Finds the first entry in a CMUDICT line, with the same result as
+     * searching it for the regular expression
+     *
+     *   ([A-Z][^ \(]*)(?:\(\d+\))?  ([A-Z 0-9]+)
+     *
+     * but without allocating. The word is the first group and the phonemes
+     * are the second, and both refer back into the line. Returns false if the
+     * line has no entry, such as when it is a comment.
+     */
+    bool findCmudictEntry(
+      std::string_view line,
+      std::string_view& word,
+      std::string_view& phonemes);
+
+  };
+};
+
+#endif /* end of include guard: CMUDICT_ENTRY_H_3B7E1D42 */
@@ -3,6 +3,7 @@
 #include <list>
 #include <cctype>
 #include "pronunciation.h"
+#include "task_graph.h"
 
 namespace verbly {
   namespace generator {
@@ -27,6 +28,8 @@ namespace verbly {
     {
       // Serialize the form first.
       {
+        task_graph::countRow("forms");
+
         db.insertIntoTable(
           "forms",
           {
@@ -41,6 +44,8 @@ namespace verbly {
       // Then, serialize the form/pronunciation relationship.
       for (const pronunciation* p : arg.getPronunciations())
       {
+        task_graph::countRow("forms_pronunciations");
+
         db.insertIntoTable(
           "forms_pronunciations",
           {
@@ -28,7 +28,7 @@ namespace verbly {
         return id_;
       }
 
-      std::string getText() const
+      const std::string& getText() const
       {
         return text_;
       }
@@ -2,30 +2,96 @@
 #include <stdexcept>
 #include <iostream>
 #include <regex>
+#include <map>
 #include <dirent.h>
+#include <sys/resource.h>
 #include <fstream>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <ctime>
+#include <thread>
+#include <algorithm>
+#include <libxml/parser.h>
 #include <hkutil/string.h>
-#include <hkutil/progress.h>
 #include "role.h"
 #include "part.h"
+#include "prolog_fact.h"
+#include "cmudict_entry.h"
+#include "line_reader.h"
 #include "../lib/enums.h"
 #include "../lib/version.h"
 
 namespace verbly {
   namespace generator {
 
+    namespace {
+
+      std::string jsonString(const std::string& value)
+      {
+        std::ostringstream result;
+        result << '"';
+
+        for (char ch : value)
+        {
+          if ((ch == '"') || (ch == '\\'))
+          {
+            result << '\\' << ch;
+          } else if (static_cast<unsigned char>(ch) < 0x20)
+          {
+            result << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+              << static_cast<int>(ch);
+          } else {
+            result << ch;
+          }
+        }
+
+        result << '"';
+
+        return result.str();
+      }
+
+      // Chosen with bench/page_touch_bench, where hydrating a word reads
+      // about a third fewer pages with 8 KiB pages than with the default
+      // 4 KiB.
+      const int datafilePageSize = 8192;
+
+      // The version of the parser behind each cached stage. A change to the
+      // records a parser produces should bump its version, so that records
+      // cached by an older generator are parsed again instead of reused.
+      const int imageNetCacheVersion = 1;
+      const int agidCacheVersion = 1;
+      const int cmudictCacheVersion = 2;
+
+      // On Linux, the maximum resident set size is measured in kilobytes.
+      long getPeakMemory()
+      {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == -1)
+        {
+          return 0;
+        }
+
+        return usage.ru_maxrss;
+      }
+
+    };
+
     generator::generator(
       std::string verbNetPath,
       std::string agidPath,
       std::string wordNetPath,
       std::string cmudictPath,
       std::string imageNetPath,
-      std::string outputPath) :
+      std::string outputPath,
+      std::string cachePath) :
         verbNetPath_(verbNetPath),
         agidPath_(agidPath),
         wordNetPath_(wordNetPath),
         cmudictPath_(cmudictPath),
         imageNetPath_(imageNetPath),
+        cache_(cachePath),
+        outputPath_(outputPath),
         db_(outputPath, hatkirby::dbmode::create)
     {
       // Ensure VerbNet directory exists
@@ -76,20 +142,41 @@ namespace verbly {
 
     void generator::run()
     {
+      auto start = std::chrono::steady_clock::now();
+
       // Create notions, words, lemmas, and forms from WordNet synsets
-      readWordNetSynsets();
+      auto synsets = tasks_.add(
+        "WordNet synsets",
+        [this] () { readWordNetSynsets(); });
 
       // Reads adjective positioning WordNet data
-      readAdjectivePositioning();
+      auto adjectivePositioning = tasks_.add(
+        "adjective positioning",
+        [this] () { readAdjectivePositioning(); },
+        { synsets });
 
       // Counts the number of URLs ImageNet has per notion
-      readImageNetUrls();
+      auto imageNet = tasks_.add(
+        "ImageNet URLs",
+        [this] () { readImageNetUrls(); },
+        { synsets });
 
       // Creates a word by WordNet sense key lookup table
-      readWordNetSenseKeys();
-
-      // Creates groups and frames from VerbNet data
-      readVerbNet();
+      auto senseKeys = tasks_.add(
+        "WordNet sense keys",
+        [this] () { readWordNetSenseKeys(); },
+        { synsets });
+
+      // Parses the VerbNet data, which does not depend on anything else
+      auto verbNet = tasks_.add(
+        "VerbNet",
+        [this] () { readVerbNet(); });
+
+      // Creates groups and frames from the parsed VerbNet data
+      auto verbNetGroups = tasks_.add(
+        "VerbNet groups",
+        [this] () { createVerbNetGroups(); },
+        { verbNet, senseKeys });
 
       // Creates forms and inflections from AGID. To reduce the amount of forms
       // created, we do this after most lemmas that need inflecting have been
@@ -99,97 +186,278 @@ namespace verbly {
       // exist but is not related to any words that are related to verb notions,
       // then a notion and a word is generated and the form generation proceeds
       // as usual.
-      readAgidInflections();
+      auto agid = tasks_.add(
+        "AGID inflections",
+        [this] () { readAgidInflections(); },
+        { verbNetGroups });
 
       // Reads in prepositions and the is_a relationship
-      readPrepositions();
+      auto prepositions = tasks_.add(
+        "prepositions",
+        [this] () { readPrepositions(); },
+        { agid });
 
       // Creates pronunciations from CMUDICT. To reduce the amount of
       // pronunciations created, we do this after all forms have been created,
       // and then only generate pronunciations for already-exisiting forms.
-      readCmudictPronunciations();
-
-      // Writes the database schema
-      writeSchema();
+      auto cmudict = tasks_.add(
+        "CMUDICT pronunciations",
+        [this] () { readCmudictPronunciations(); },
+        { prepositions });
+
+      // Writes the database schema, except for the indexes, which are faster
+      // to create once the data has been written. Every other write depends on
+      // this, which makes sure that the tables exist before they are written.
+      auto schema = tasks_.add(
+        "schema",
+        [this] () { writeSchema(); });
 
       // Writes the database version
-      writeVersion();
+      auto version = tasks_.add(
+        "version",
+        [this] () { writeVersion(); },
+        { schema });
+
+      // Dumps data to the database, once nothing else is going to modify it
+      auto objects = tasks_.add(
+        "objects",
+        [this] () { dumpObjects(); },
+        { schema, adjectivePositioning, imageNet, cmudict });
+
+      // The relation readers only look up words and notions that were created
+      // from WordNet synsets, and the lookup tables they use are not modified
+      // by any of the later phases. They also write to distinct tables, so
+      // they can all run alongside each other and the rest of the phases.
+      std::list<task_graph::task_id> writers = { version, objects };
+
+      std::list<std::pair<std::string, void (generator::*)()>> relations = {
+        // Populates the antonymy relationship from WordNet
+        { "antonymy", &generator::readWordNetAntonymy },
+
+        // Populates the variation relationship from WordNet
+        { "variation", &generator::readWordNetVariation },
 
-      // Dumps data to the database
-      dumpObjects();
+        // Populates the usage, topicality, and regionality relationships from
+        // WordNet
+        { "classes", &generator::readWordNetClasses },
 
-      // Populates the antonymy relationship from WordNet
-      readWordNetAntonymy();
+        // Populates the causality relationship from WordNet
+        { "causality", &generator::readWordNetCausality },
 
-      // Populates the variation relationship from WordNet
-      readWordNetVariation();
+        // Populates the entailment relationship from WordNet
+        { "entailment", &generator::readWordNetEntailment },
 
-      // Populates the usage, topicality, and regionality relationships from
-      // WordNet
-      readWordNetClasses();
+        // Populates the hypernymy relationship from WordNet
+        { "hypernymy", &generator::readWordNetHypernymy },
 
-      // Populates the causality relationship from WordNet
-      readWordNetCausality();
+        // Populates the instantiation relationship from WordNet
+        { "instantiation", &generator::readWordNetInstantiation },
 
-      // Populates the entailment relationship from WordNet
-      readWordNetEntailment();
+        // Populates the member meronymy relationship from WordNet
+        { "member meronymy", &generator::readWordNetMemberMeronymy },
 
-      // Populates the hypernymy relationship from WordNet
-      readWordNetHypernymy();
+        // Populates the part meronymy relationship from WordNet
+        { "part meronymy", &generator::readWordNetPartMeronymy },
 
-      // Populates the instantiation relationship from WordNet
-      readWordNetInstantiation();
+        // Populates the substance meronymy relationship from WordNet
+        { "substance meronymy", &generator::readWordNetSubstanceMeronymy },
 
-      // Populates the member meronymy relationship from WordNet
-      readWordNetMemberMeronymy();
+        // Populates the pertainymy and mannernymy relationships from WordNet
+        { "pertainymy", &generator::readWordNetPertainymy },
+
+        // Populates the specification relationship from WordNet
+        { "specification", &generator::readWordNetSpecification },
+
+        // Populates the adjective similarity relationship from WordNet
+        { "similarity", &generator::readWordNetSimilarity }
+      };
+
+      for (const auto& relation : relations)
+      {
+        auto phase = relation.second;
+
+        writers.push_back(
+          tasks_.add(
+            relation.first,
+            [this, phase] () { (this->*phase)(); },
+            { schema, synsets }));
+      }
 
-      // Populates the part meronymy relationship from WordNet
-      readWordNetPartMeronymy();
+      // Renumbers forms and pronunciations once all of the data has been
+      // written, so that they are stored near the lemmas that use them
+      auto layout = tasks_.add(
+        "layout",
+        [this] () { layoutDatabase(); },
+        writers);
 
-      // Populates the substance meronymy relationship from WordNet
-      readWordNetSubstanceMeronymy();
+      // Creates the indexes now that all of the data has been written
+      tasks_.add(
+        "indexes",
+        [this] () { writeIndexes(); },
+        { layout });
 
-      // Populates the pertainymy and mannernymy relationships from WordNet
-      readWordNetPertainymy();
+      // The page size has to be set before the first table is created. Larger
+      // pages make the tables shallower, which means fewer pages are read to
+      // hydrate a word, at the cost of reading more bytes for each page.
+      db_.execute("PRAGMA page_size = " + std::to_string(datafilePageSize));
 
-      // Populates the specification relationship from WordNet
-      readWordNetSpecification();
+      // The datafile is written in a single transaction without a rollback
+      // journal, since a partially written datafile is useless anyway.
+      db_.execute("PRAGMA journal_mode = OFF");
+      db_.execute("PRAGMA synchronous = OFF");
+      db_.execute("BEGIN TRANSACTION");
 
-      // Populates the adjective similarity relationship from WordNet
-      readWordNetSimilarity();
+      // The parsing runs on one worker thread per core, while this thread
+      // performs all of the writes.
+      tasks_.run(std::thread::hardware_concurrency());
+
+      phaseProfiles_ = tasks_.getProfiles();
+      phaseProfiles_.push_back(tasks_.getWriterProfile());
+
+      db_.execute("COMMIT");
+
+      // Rewrites the datafile so that each table is stored contiguously.
+      runPhase("compaction", &generator::compactDatabase);
 
       // Generates analysis data to assist in query planning.
-      analyzeDatabase();
+      runPhase("analysis", &generator::analyzeDatabase);
+
+      std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+      std::cout << "Phase timings (wall, CPU):" << std::endl;
+      std::cout << std::fixed << std::setprecision(3);
+
+      for (const task_graph::profile& phase : phaseProfiles_)
+      {
+        std::cout << "  " << phase.name << ": " << phase.wallTime << "s, "
+          << phase.cpuTime << "s" << std::endl;
+      }
+
+      // Phases overlap, so the elapsed time is less than their sum.
+      std::cout << "  elapsed: " << elapsed.count() << "s" << std::endl;
+
+      std::cout << "Peak memory: " << (getPeakMemory() / 1024.0) << " MB"
+        << std::endl;
+
+      writeProfile(elapsed.count());
     }
 
-    void generator::readWordNetSynsets()
+    void generator::runPhase(std::string name, void (generator::*phase)())
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_s.pl"));
-      hatkirby::progress ppgs("Reading synsets from WordNet...", lines.size());
+      auto start = std::chrono::steady_clock::now();
+      std::clock_t cpuStart = std::clock();
+
+      (this->*phase)();
+
+      std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+      task_graph::profile stats;
+      stats.name = std::move(name);
+      stats.wallTime = elapsed.count();
+      stats.cpuTime =
+        static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+      stats.peakMemory = getPeakMemory();
+
+      phaseProfiles_.push_back(std::move(stats));
+    }
 
-      for (std::string line : lines)
+    /**
+     * The report is written next to the datafile, so that build performance
+     * can be compared across runs. Times are in seconds and memory is in
+     * kilobytes. Row counts per phase include the rows written on behalf of
+     * the phase, and the totals per table are counted from the datafile
+     * itself.
+     */
+    void generator::writeProfile(double elapsed)
+    {
+      std::string path = outputPath_ + ".profile.json";
+      std::ofstream file(path);
+      if (!file)
       {
-        ppgs.update();
+        throw std::runtime_error("Could not write profile " + path);
+      }
 
-        std::regex relation(
-          "^s\\(([1234]\\d{8}),(\\d+),'(.+)',\\w,\\d+,(\\d+)\\)\\.$");
+      file << std::fixed << std::setprecision(6);
+      file << "{" << std::endl;
+      file << "  \"database_version\": \"" << DATABASE_MAJOR_VERSION << "."
+        << DATABASE_MINOR_VERSION << "\"," << std::endl;
+      file << "  \"elapsed\": " << elapsed << "," << std::endl;
+      file << "  \"peak_memory\": " << getPeakMemory() << "," << std::endl;
+      file << "  \"phases\": [" << std::endl;
+
+      for (auto it = std::begin(phaseProfiles_);
+        it != std::end(phaseProfiles_);
+        it++)
+      {
+        file << "    {" << std::endl;
+        file << "      \"name\": " << jsonString(it->name) << "," << std::endl;
+        file << "      \"wall_time\": " << it->wallTime << "," << std::endl;
+        file << "      \"cpu_time\": " << it->cpuTime << "," << std::endl;
+        file << "      \"lines\": " << it->lines << "," << std::endl;
+        file << "      \"rows\": {";
 
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        for (auto row = std::begin(it->rows); row != std::end(it->rows); row++)
         {
-          continue;
+          file << ((row == std::begin(it->rows)) ? "" : ", ")
+            << jsonString(row->first) << ": " << row->second;
         }
 
-        int synset_id = std::stoi(relation_data[1]);
-        int wnum = std::stoi(relation_data[2]);
-        std::string text = relation_data[3];
-        int tag_count = std::stoi(relation_data[4]);
-        size_t word_it;
-        while ((word_it = text.find("''")) != std::string::npos)
+        file << "}," << std::endl;
+        file << "      \"peak_memory\": " << it->peakMemory << std::endl;
+        file << "    }" << ((std::next(it) == std::end(phaseProfiles_)) ? "" : ",")
+          << std::endl;
+      }
+
+      file << "  ]," << std::endl;
+      file << "  \"tables\": {" << std::endl;
+
+      std::vector<hatkirby::row> tables = db_.queryAll(
+        "SELECT name FROM sqlite_master \
+         WHERE type = 'table' AND name NOT LIKE 'sqlite_%' \
+         ORDER BY name");
+
+      for (size_t i = 0; i < tables.size(); i++)
+      {
+        std::string table = std::get<std::string>(tables[i][0]);
+
+        int count = std::get<int>(
+          db_.queryFirst("SELECT COUNT(*) FROM " + table)[0]);
+
+        file << "    " << jsonString(table) << ": " << count
+          << (((i + 1) == tables.size()) ? "" : ",") << std::endl;
+      }
+
+      file << "  }" << std::endl;
+      file << "}" << std::endl;
+
+      std::cout << "Wrote profile to " << path << "." << std::endl;
+    }
+
+    void generator::readWordNetSynsets()
+    {
+      line_reader lines(wordNetPath_ + "wn_s.pl");
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
+      {
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "s")
+          || (fact.getArgumentCount() != 6)
+          || !fact.isSynset(0, "1234")
+          || !fact.isInteger(1)
+          || fact.getRaw(2).empty()
+          || !fact.isInteger(5))
         {
-          text.erase(word_it, 1);
+          continue;
         }
 
+        int synset_id = fact.getInteger(0);
+        int wnum = fact.getInteger(1);
+        std::string text = fact.getString(2);
+        int tag_count = fact.getInteger(5);
+
         // The WordNet data does contain duplicates, so we need to check that we
         // haven't already created this word.
         std::pair<int, int> lookup(synset_id, wnum);
@@ -202,30 +470,37 @@ namespace verbly {
           wordByWnidAndWnum_[lookup] = &entry;
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readAdjectivePositioning()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_syntax.pl"));
+      line_reader lines(wordNetPath_ + "wn_syntax.pl");
 
-      hatkirby::progress ppgs(
-        "Reading adjective positionings from WordNet...",
-        lines.size());
-
-      for (std::string line : lines)
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "syntax")
+          || (fact.getArgumentCount() != 3)
+          || !fact.isSynset(0, "3")
+          || !fact.isInteger(1))
+        {
+          continue;
+        }
 
-        std::regex relation("^syntax\\((3\\d{8}),(\\d+),([ipa])p?\\)\\.");
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        // The position is one of p, a, or ip.
+        std::string_view adjpos = fact.getRaw(2);
+        if ((adjpos != "p") && (adjpos != "a") && (adjpos != "ip"))
         {
           continue;
         }
 
-        int synset_id = stoi(relation_data[1]);
-        int wnum = stoi(relation_data[2]);
-        std::string adjpos_str = relation_data[3];
+        int synset_id = fact.getInteger(0);
+        int wnum = fact.getInteger(1);
+        std::string adjpos_str(adjpos.substr(0, 1));
 
         std::pair<int, int> lookup(synset_id, wnum);
         if (wordByWnidAndWnum_.count(lookup))
@@ -246,63 +521,80 @@ namespace verbly {
           }
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readImageNetUrls()
     {
-      // The ImageNet datafile is so large that it is unreasonable and
-      // unnecessary to read it into memory; instead, we will parse each line as
-      // we read it. This has the caveat that we cannot display a progress bar.
-      std::cout << "Reading image counts from ImageNet..." << std::endl;
+      // The URL list is large, but only the number of URLs per notion is
+      // needed, so that is what gets cached.
+      auto counts = cache_.fetch("imagenet", imageNetCacheVersion, imageNetPath_, [&] () {
+        std::map<int, int> urlsByWnid;
 
-      std::ifstream file(imageNetPath_);
-      if (!file)
-      {
-        throw std::invalid_argument("Could not find file " + imageNetPath_);
-      }
+        line_reader lines(imageNetPath_);
+        std::string_view line;
+        while (lines.next(line))
+        {
+          std::string wnid_s(line.substr(1, 8));
+          int wnid = stoi(wnid_s) + 100000000;
 
-      std::string line;
-      while (std::getline(file, line))
-      {
-        if (line.back() == '\r')
+          urlsByWnid[wnid]++;
+        }
+
+        task_graph::countLines(lines.getLineCount());
+
+        std::vector<stage_cache::record> result;
+        for (const auto& mapping : urlsByWnid)
         {
-          line.pop_back();
+          result.push_back({
+            std::to_string(mapping.first),
+            std::to_string(mapping.second)
+          });
         }
 
-        std::string wnid_s = line.substr(1, 8);
-        int wnid = stoi(wnid_s) + 100000000;
+        return result;
+      });
+
+      for (const stage_cache::record& count : counts)
+      {
+        int wnid = std::stoi(count[0]);
         if (notionByWnid_.count(wnid))
         {
           // We know that this notion has a wnid and is a noun.
-          notionByWnid_.at(wnid)->incrementNumOfImages();
+          notion& n = *notionByWnid_.at(wnid);
+
+          for (int i = std::stoi(count[1]); i > 0; i--)
+          {
+            n.incrementNumOfImages();
+          }
         }
       }
     }
 
     void generator::readWordNetSenseKeys()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_sk.pl"));
-
-      hatkirby::progress ppgs(
-        "Reading sense keys from WordNet...",
-        lines.size());
+      line_reader lines(wordNetPath_ + "wn_sk.pl");
 
-      for (std::string line : lines)
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
         // We only actually need to lookup verbs by sense key so we'll just
         // ignore everything that isn't a verb.
-        std::regex relation("^sk\\((2\\d{8}),(\\d+),'(.+)'\\)\\.$");
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "sk")
+          || (fact.getArgumentCount() != 3)
+          || !fact.isSynset(0, "2")
+          || !fact.isInteger(1)
+          || fact.getRaw(2).empty())
         {
           continue;
         }
 
-        int synset_id = stoi(relation_data[1]);
-        int wnum = stoi(relation_data[2]);
-        std::string sense_key = relation_data[3];
+        int synset_id = fact.getInteger(0);
+        int wnum = fact.getInteger(1);
+        std::string sense_key(fact.getRaw(2));
 
         // We are treating this mapping as injective, which is not entirely
         // accurate. First, the WordNet table contains duplicate rows, so those
@@ -320,18 +612,20 @@ namespace verbly {
           }
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readVerbNet()
     {
-      std::cout << "Reading frames from VerbNet..." << std::endl;
-
       DIR* dir;
       if ((dir = opendir(verbNetPath_.c_str())) == nullptr)
       {
         throw std::invalid_argument("Invalid VerbNet data directory");
       }
 
+      std::vector<std::string> filenames;
+
       struct dirent* ent;
       while ((ent = readdir(dir)) != nullptr)
       {
@@ -349,189 +643,230 @@ namespace verbly {
           continue;
         }
 
-        xmlDocPtr doc = xmlParseFile(filename.c_str());
-        if (doc == nullptr)
-        {
-          throw std::logic_error("Error opening " + filename);
-        }
+        filenames.push_back(std::move(filename));
+      }
 
-        xmlNodePtr top = xmlDocGetRootElement(doc);
-        if ((top == nullptr) ||
-            (xmlStrcmp(top->name, reinterpret_cast<const xmlChar*>("VNCLASS"))))
-        {
-          throw std::logic_error("Bad VerbNet file format: " + filename);
-        }
+      closedir(dir);
+
+      // The groups are created in filename order, rather than in the order the
+      // files finish parsing or the order the directory lists them in, so that
+      // their IDs are the same every time.
+      std::sort(std::begin(filenames), std::end(filenames));
 
+      verbNetClasses_.resize(filenames.size());
+
+      // libxml needs to be initialized before it is used from multiple
+      // threads.
+      xmlInitParser();
+
+      tasks_.parallelFor(filenames.size(), [&] (size_t i) {
         try
         {
-          createGroup(top);
+          verbNetClasses_[i] = verbnet_class(filenames[i]);
         } catch (const std::exception& e)
         {
           std::throw_with_nested(
-            std::logic_error("Error parsing VerbNet file: " + filename));
+            std::logic_error("Error parsing VerbNet file: " + filenames[i]));
         }
-      }
-
-      closedir(dir);
+      });
     }
 
-    void generator::readAgidInflections()
+    void generator::createVerbNetGroups()
     {
-      std::list<std::string> lines(readFile(agidPath_));
-      hatkirby::progress ppgs("Reading inflections from AGID...", lines.size());
-
-      for (std::string line : lines)
+      for (const verbnet_class& vnc : verbNetClasses_)
       {
-        ppgs.update();
+        createGroup(vnc);
+      }
 
-        int divider = line.find_first_of(" ");
-        std::string infinitive = line.substr(0, divider);
-        line = line.substr(divider+1);
-        char type = line[0];
+      verbNetClasses_.clear();
+    }
 
-        if (line[1] == '?')
-        {
-          line.erase(0, 4);
-        } else {
-          line.erase(0, 3);
-        }
+    void generator::readAgidInflections()
+    {
+      // Each record is an infinitive and its part of speech, followed by pairs
+      // of an inflection and one of its forms.
+      auto entries = cache_.fetch("agid", agidCacheVersion, agidPath_, [&] () {
+        std::vector<stage_cache::record> result;
 
-        if (!lemmaByBaseForm_.count(infinitive) && (type != 'V'))
+        line_reader lines(agidPath_);
+        std::string_view rawLine;
+        while (lines.next(rawLine))
         {
-          continue;
-        }
+          std::string line(rawLine);
 
-        lemma& curLemma = lookupOrCreateLemma(infinitive);
+          int divider = line.find_first_of(" ");
+          std::string infinitive = line.substr(0, divider);
+          line = line.substr(divider+1);
+          char type = line[0];
 
-        auto inflWordList =
-          hatkirby::split<std::list<std::string>>(line, " | ");
+          if (line[1] == '?')
+          {
+            line.erase(0, 4);
+          } else {
+            line.erase(0, 3);
+          }
 
-        std::vector<std::list<std::string>> agidForms;
-        for (std::string inflForms : inflWordList)
-        {
-          auto inflFormList =
-            hatkirby::split<std::list<std::string>>(std::move(inflForms), ", ");
+          auto inflWordList =
+            hatkirby::split<std::list<std::string>>(line, " | ");
 
-          std::list<std::string> forms;
-          for (std::string inflForm : inflFormList)
+          std::vector<std::list<std::string>> agidForms;
+          for (std::string inflForms : inflWordList)
           {
-            int sympos = inflForm.find_first_of("~<!? ");
-            if (sympos != std::string::npos)
+            auto inflFormList =
+              hatkirby::split<std::list<std::string>>(std::move(inflForms), ", ");
+
+            std::list<std::string> forms;
+            for (std::string inflForm : inflFormList)
             {
-              inflForm = inflForm.substr(0, sympos);
+              int sympos = inflForm.find_first_of("~<!? ");
+              if (sympos != std::string::npos)
+              {
+                inflForm = inflForm.substr(0, sympos);
+              }
+
+              forms.push_back(std::move(inflForm));
             }
 
-            forms.push_back(std::move(inflForm));
+            agidForms.push_back(std::move(forms));
           }
 
-          agidForms.push_back(std::move(forms));
-        }
-
-        std::map<inflection, std::list<std::string>> mappedForms;
-        switch (type)
-        {
-          case 'V':
+          std::map<inflection, std::list<std::string>> mappedForms;
+          switch (type)
           {
-            if (agidForms.size() == 4)
+            case 'V':
             {
-              mappedForms[inflection::past_tense] = agidForms[0];
-              mappedForms[inflection::past_participle] = agidForms[1];
-              mappedForms[inflection::ing_form] = agidForms[2];
-              mappedForms[inflection::s_form] = agidForms[3];
-            } else if (agidForms.size() == 3)
-            {
-              mappedForms[inflection::past_tense] = agidForms[0];
-              mappedForms[inflection::past_participle] = agidForms[0];
-              mappedForms[inflection::ing_form] = agidForms[1];
-              mappedForms[inflection::s_form] = agidForms[2];
-            } else if (agidForms.size() == 8)
-            {
-              // As of AGID 2014.08.11, this is only "to be"
-              mappedForms[inflection::past_tense] = agidForms[0];
-              mappedForms[inflection::past_participle] = agidForms[2];
-              mappedForms[inflection::ing_form] = agidForms[3];
-              mappedForms[inflection::s_form] = agidForms[4];
-            } else {
-              // Words that don't fit the cases above as of AGID 2014.08.11:
-              // - may and shall do not conjugate the way we want them to
-              // - methinks only has a past tense and is an outlier
-              // - wit has five forms, and is archaic/obscure enough that we can ignore it for now
-              std::cout << " Ignoring verb \"" << infinitive
-                << "\" due to non-standard number of forms." << std::endl;
+              if (agidForms.size() == 4)
+              {
+                mappedForms[inflection::past_tense] = agidForms[0];
+                mappedForms[inflection::past_participle] = agidForms[1];
+                mappedForms[inflection::ing_form] = agidForms[2];
+                mappedForms[inflection::s_form] = agidForms[3];
+              } else if (agidForms.size() == 3)
+              {
+                mappedForms[inflection::past_tense] = agidForms[0];
+                mappedForms[inflection::past_participle] = agidForms[0];
+                mappedForms[inflection::ing_form] = agidForms[1];
+                mappedForms[inflection::s_form] = agidForms[2];
+              } else if (agidForms.size() == 8)
+              {
+                // As of AGID 2014.08.11, this is only "to be"
+                mappedForms[inflection::past_tense] = agidForms[0];
+                mappedForms[inflection::past_participle] = agidForms[2];
+                mappedForms[inflection::ing_form] = agidForms[3];
+                mappedForms[inflection::s_form] = agidForms[4];
+              } else {
+                // Words that don't fit the cases above as of AGID 2014.08.11:
+                // - may and shall do not conjugate the way we want them to
+                // - methinks only has a past tense and is an outlier
+                // - wit has five forms, and is archaic/obscure enough that we can ignore it for now
+                std::cout << " Ignoring verb \"" << infinitive
+                  << "\" due to non-standard number of forms." << std::endl;
+              }
+
+              break;
             }
 
-            // For verbs in particular, we sometimes create a notion and a word
-            // from inflection data. Specifically, if there are not yet any
-            // verbs existing that have the same infinitive form. "Yet" means
-            // that this verb appears in the AGID data but not in either WordNet
-            // or VerbNet.
-            if (!wordsByBaseForm_.count(infinitive)
-              || !std::any_of(
-                std::begin(wordsByBaseForm_.at(infinitive)),
-                std::end(wordsByBaseForm_.at(infinitive)),
-                [] (word* w) {
-                  return (w->getNotion().getPartOfSpeech() ==
-                    part_of_speech::verb);
-                }))
+            case 'A':
             {
-              notion& n = createNotion(part_of_speech::verb);
-              createWord(n, curLemma);
-            }
+              if (agidForms.size() == 2)
+              {
+                mappedForms[inflection::comparative] = agidForms[0];
+                mappedForms[inflection::superlative] = agidForms[1];
+              } else {
+                // As of AGID 2014.08.11, this is only "only", which has only the form "onliest"
+                std::cout << " Ignoring adjective/adverb \"" << infinitive
+                  << "\" due to non-standard number of forms." << std::endl;
+              }
 
-            break;
-          }
+              break;
+            }
 
-          case 'A':
-          {
-            if (agidForms.size() == 2)
+            case 'N':
             {
-              mappedForms[inflection::comparative] = agidForms[0];
-              mappedForms[inflection::superlative] = agidForms[1];
-            } else {
-              // As of AGID 2014.08.11, this is only "only", which has only the form "onliest"
-              std::cout << " Ignoring adjective/adverb \"" << infinitive
-                << "\" due to non-standard number of forms." << std::endl;
-            }
+              if (agidForms.size() == 1)
+              {
+                mappedForms[inflection::plural] = agidForms[0];
+              } else {
+                // As of AGID 2014.08.11, this is non-existent.
+                std::cout << " Ignoring noun \"" << infinitive
+                  << "\" due to non-standard number of forms." << std::endl;
+              }
 
-            break;
+              break;
+            }
           }
 
-          case 'N':
+          stage_cache::record entry = { infinitive, std::string(1, type) };
+
+          for (auto mapping : std::move(mappedForms))
           {
-            if (agidForms.size() == 1)
+            for (std::string infl : std::move(mapping.second))
             {
-              mappedForms[inflection::plural] = agidForms[0];
-            } else {
-              // As of AGID 2014.08.11, this is non-existent.
-              std::cout << " Ignoring noun \"" << infinitive
-                << "\" due to non-standard number of forms." << std::endl;
-            }
+              entry.push_back(
+                std::to_string(static_cast<int>(mapping.first)));
 
-            break;
+              entry.push_back(std::move(infl));
+            }
           }
+
+          result.push_back(std::move(entry));
         }
 
-        // Compile the forms we have mapped.
-        for (auto mapping : std::move(mappedForms))
+        task_graph::countLines(lines.getLineCount());
+
+        return result;
+      });
+
+      for (const stage_cache::record& entry : entries)
+      {
+        const std::string& infinitive = entry[0];
+        char type = entry[1][0];
+
+        if (!lemmaByBaseForm_.count(infinitive) && (type != 'V'))
         {
-          for (std::string infl : std::move(mapping.second))
+          continue;
+        }
+
+        lemma& curLemma = lookupOrCreateLemma(infinitive);
+
+        if (type == 'V')
+        {
+          // For verbs in particular, we sometimes create a notion and a word
+          // from inflection data. Specifically, if there are not yet any
+          // verbs existing that have the same infinitive form. "Yet" means
+          // that this verb appears in the AGID data but not in either WordNet
+          // or VerbNet.
+          if (!wordsByBaseForm_.count(infinitive)
+            || !std::any_of(
+              std::begin(wordsByBaseForm_.at(infinitive)),
+              std::end(wordsByBaseForm_.at(infinitive)),
+              [] (word* w) {
+                return (w->getNotion().getPartOfSpeech() ==
+                  part_of_speech::verb);
+              }))
           {
-            curLemma.addInflection(
-              mapping.first,
-              lookupOrCreateForm(std::move(infl)));
+            notion& n = createNotion(part_of_speech::verb);
+            createWord(n, curLemma);
           }
         }
+
+        // Compile the forms we have mapped.
+        for (size_t i = 2; i + 1 < entry.size(); i += 2)
+        {
+          curLemma.addInflection(
+            static_cast<inflection>(std::stoi(entry[i])),
+            lookupOrCreateForm(entry[i + 1]));
+        }
       }
     }
 
     void generator::readPrepositions()
     {
-      std::list<std::string> lines(readFile("prepositions.txt"));
-      hatkirby::progress ppgs("Reading prepositions...", lines.size());
-
-      for (std::string line : lines)
+      line_reader lines("prepositions.txt");
+      std::string_view rawLine;
+      while (lines.next(rawLine))
       {
-        ppgs.update();
+        std::string line(rawLine);
 
         std::regex relation("^([^:]+): (.+)");
         std::smatch relation_data;
@@ -547,41 +882,81 @@ namespace verbly {
 
         n.setPrepositionGroups(groups);
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readCmudictPronunciations()
     {
-      std::list<std::string> lines(readFile(cmudictPath_));
+      auto entries = cache_.fetch("cmudict", cmudictCacheVersion, cmudictPath_, [&] () {
+        line_reader lines(cmudictPath_);
 
-      hatkirby::progress ppgs(
-        "Reading pronunciations from CMUDICT...",
-        lines.size());
+        std::vector<std::string_view> rawLines;
+        std::string_view rawLine;
+        while (lines.next(rawLine))
+        {
+          rawLines.push_back(rawLine);
+        }
 
-      for (std::string line : lines)
-      {
-        ppgs.update();
+        task_graph::countLines(lines.getLineCount());
 
-        std::regex phoneme("([A-Z][^ \\(]*)(?:\\(\\d+\\))?  ([A-Z 0-9]+)");
-        std::smatch phoneme_data;
-        if (std::regex_search(line, phoneme_data, phoneme))
-        {
-          std::string canonical = hatkirby::lowercase(phoneme_data[1]);
+        // The lines are split into fixed-size chunks, which are parsed by
+        // whichever workers are idle. The entries from each chunk are then
+        // concatenated in order, so that the result does not depend on the
+        // scheduling.
+        const size_t chunkSize = 4096;
+        size_t chunkCount = (rawLines.size() + chunkSize - 1) / chunkSize;
+
+        std::vector<std::vector<stage_cache::record>> chunks(chunkCount);
+
+        tasks_.parallelFor(chunkCount, [&] (size_t i) {
+          size_t end = std::min(rawLines.size(), (i + 1) * chunkSize);
 
-          if (!formByText_.count(canonical))
+          for (size_t j = i * chunkSize; j < end; j++)
           {
-            continue;
+            std::string_view word;
+            std::string_view phonemes;
+            if (findCmudictEntry(rawLines[j], word, phonemes))
+            {
+              chunks[i].push_back({
+                hatkirby::lowercase(std::string(word)),
+                std::string(phonemes)
+              });
+            }
           }
+        });
 
-          std::string phonemes = phoneme_data[2];
-          if (pronunciationByPhonemes_.count(phonemes)) {
-            pronunciation& p = *pronunciationByPhonemes_[phonemes];
-            formByText_.at(canonical)->addPronunciation(p);
-          } else {
-            pronunciations_.emplace_back(phonemes);
-            pronunciation& p = pronunciations_.back();
-            pronunciationByPhonemes_[phonemes] = &p;
-            formByText_.at(canonical)->addPronunciation(p);
-          }
+        std::vector<stage_cache::record> result;
+        for (std::vector<stage_cache::record>& chunk : chunks)
+        {
+          std::move(
+            std::begin(chunk),
+            std::end(chunk),
+            std::back_inserter(result));
+        }
+
+        return result;
+      });
+
+      for (const stage_cache::record& entry : entries)
+      {
+        const std::string& canonical = entry[0];
+
+        if (!formByText_.count(canonical))
+        {
+          continue;
+        }
+
+        const std::string& phonemes = entry[1];
+        auto it = pronunciationByPhonemes_.find(phonemes);
+        if (it != std::end(pronunciationByPhonemes_)) {
+          pronunciation& p = *it->second;
+          formByText_.at(canonical)->addPronunciation(p);
+        } else {
+          pronunciations_.emplace_back(phonemes);
+          pronunciation& p = pronunciations_.back();
+          pronunciationByPhonemes_.emplace(p.getPhonemes(), &p);
+          formByText_.at(canonical)->addPronunciation(p);
         }
       }
     }
@@ -598,7 +973,7 @@ namespace verbly {
       std::string line;
       while (std::getline(file, line))
       {
-        if (line.back() == '\r')
+        if (!line.empty() && (line.back() == '\r'))
         {
           line.pop_back();
         }
@@ -609,21 +984,39 @@ namespace verbly {
       std::string schema = schemaBuilder.str();
       auto queries = hatkirby::split<std::list<std::string>>(schema, ";");
 
-      hatkirby::progress ppgs("Writing database schema...", queries.size());
       for (std::string query : queries)
       {
-        if (!queries.empty())
+        if (query.empty())
         {
-          db_.execute(query);
+          continue;
         }
 
-        ppgs.update();
+        // Indexes are created by writeIndexes after the data is written.
+        if ((query.compare(0, 12, "CREATE INDEX") == 0)
+          || (query.compare(0, 19, "CREATE UNIQUE INDEX") == 0))
+        {
+          indexQueries_.push_back(std::move(query));
+        } else {
+          tasks_.write([this, query] () {
+            db_.execute(query);
+          });
+        }
+      }
+    }
+
+    void generator::writeIndexes()
+    {
+      for (const std::string& query : indexQueries_)
+      {
+        tasks_.write([this, query] () {
+          db_.execute(query);
+        });
       }
     }
 
     void generator::writeVersion()
     {
-      db_.insertIntoTable(
+      writeRow(
         "version",
         {
           { "major", DATABASE_MAJOR_VERSION },
@@ -633,98 +1026,77 @@ namespace verbly {
 
     void generator::dumpObjects()
     {
-      {
-        hatkirby::progress ppgs("Writing notions...", notions_.size());
-
+      // The objects are not modified after this point, so the writer can read
+      // them while the relation readers are running.
+      tasks_.write([this] () {
         for (notion& n : notions_)
         {
           db_ << n;
-
-          ppgs.update();
         }
-      }
-
-      {
-        hatkirby::progress ppgs("Writing words...", words_.size());
+      });
 
+      tasks_.write([this] () {
         for (word& w : words_)
         {
           db_ << w;
-
-          ppgs.update();
         }
-      }
-
-      {
-        hatkirby::progress ppgs("Writing lemmas...", lemmas_.size());
+      });
 
+      tasks_.write([this] () {
         for (lemma& l : lemmas_)
         {
           db_ << l;
-
-          ppgs.update();
         }
-      }
-
-      {
-        hatkirby::progress ppgs("Writing forms...", forms_.size());
+      });
 
+      tasks_.write([this] () {
         for (form& f : forms_)
         {
           db_ << f;
-
-          ppgs.update();
         }
-      }
-
-      {
-        hatkirby::progress ppgs("Writing pronunciations...", pronunciations_.size());
+      });
 
+      tasks_.write([this] () {
         for (pronunciation& p : pronunciations_)
         {
           db_ << p;
-
-          ppgs.update();
         }
-      }
-
-      {
-        hatkirby::progress ppgs("Writing verb frames...", groups_.size());
+      });
 
+      tasks_.write([this] () {
         for (group& g : groups_)
         {
-          db_ << g;
-
-          ppgs.update();
+          serializeGroup(db_, g, restrictions_);
         }
-      }
+      });
     }
 
     void generator::readWordNetAntonymy()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_ant.pl", true));
+      line_reader lines(wordNetPath_ + "wn_ant.pl", true);
 
-      hatkirby::progress ppgs("Writing antonyms...", lines.size());
-      for (auto line : lines)
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation(
-          "^ant\\(([134]\\d{8}),(\\d+),([134]\\d{8}),(\\d+)\\)\\.");
-
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "ant")
+          || (fact.getArgumentCount() != 4)
+          || !fact.isSynset(0, "134")
+          || !fact.isInteger(1)
+          || !fact.isSynset(2, "134")
+          || !fact.isInteger(3))
         {
           continue;
         }
 
         std::pair<int, int> lookup1(
-          std::stoi(relation_data[1]),
-          std::stoi(relation_data[2]));
+          fact.getInteger(0),
+          fact.getInteger(1));
 
         std::pair<int, int> lookup2(
-          std::stoi(relation_data[3]),
-          std::stoi(relation_data[4]));
+          fact.getInteger(2),
+          fact.getInteger(3));
 
         if (wordByWnidAndWnum_.count(lookup1) &&
             wordByWnidAndWnum_.count(lookup2))
@@ -732,7 +1104,7 @@ namespace verbly {
           word& word1 = *wordByWnidAndWnum_.at(lookup1);
           word& word2 = *wordByWnidAndWnum_.at(lookup2);
 
-          db_.insertIntoTable(
+          writeRow(
             "antonymy",
             {
               { "antonym_1_id", word1.getId() },
@@ -740,32 +1112,35 @@ namespace verbly {
             });
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readWordNetVariation()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_at.pl"));
-      hatkirby::progress ppgs("Writing variation...", lines.size());
-      for (auto line : lines)
+      line_reader lines(wordNetPath_ + "wn_at.pl");
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation("^at\\((1\\d{8}),(3\\d{8})\\)\\.");
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "at")
+          || (fact.getArgumentCount() != 2)
+          || !fact.isSynset(0, "1")
+          || !fact.isSynset(1, "3"))
         {
           continue;
         }
 
-        int lookup1 = std::stoi(relation_data[1]);
-        int lookup2 = std::stoi(relation_data[2]);
+        int lookup1 = fact.getInteger(0);
+        int lookup2 = fact.getInteger(1);
 
         if (notionByWnid_.count(lookup1) && notionByWnid_.count(lookup2))
         {
           notion& notion1 = *notionByWnid_.at(lookup1);
           notion& notion2 = *notionByWnid_.at(lookup2);
 
-          db_.insertIntoTable(
+          writeRow(
             "variation",
             {
               { "noun_id", notion1.getId() },
@@ -773,38 +1148,38 @@ namespace verbly {
             });
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readWordNetClasses()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_cls.pl", true));
-
-      hatkirby::progress ppgs(
-        "Writing usage, topicality, and regionality...",
-        lines.size());
+      line_reader lines(wordNetPath_ + "wn_cls.pl", true);
 
-      for (auto line : lines)
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation(
-          "^cls\\(([134]\\d{8}),(\\d+),(1\\d{8}),(\\d+),([tur])\\)\\.");
-
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "cls")
+          || (fact.getArgumentCount() != 5)
+          || !fact.isSynset(0, "134")
+          || !fact.isInteger(1)
+          || !fact.isSynset(2, "1")
+          || !fact.isInteger(3))
         {
           continue;
         }
 
         std::pair<int, int> lookup1(
-          std::stoi(relation_data[1]),
-          std::stoi(relation_data[2]));
+          fact.getInteger(0),
+          fact.getInteger(1));
 
         std::pair<int, int> lookup2(
-          std::stoi(relation_data[3]),
-          std::stoi(relation_data[4]));
+          fact.getInteger(2),
+          fact.getInteger(3));
 
-        std::string class_type = relation_data[5];
+        std::string class_type(fact.getRaw(4));
 
         std::string table_name;
         if (class_type == "t")
@@ -816,6 +1191,8 @@ namespace verbly {
         } else if (class_type == "r")
         {
           table_name += "regionality";
+        } else {
+          continue;
         }
 
         std::list<int> leftJoin;
@@ -855,7 +1232,7 @@ namespace verbly {
         {
           for (int word2 : rightJoin)
           {
-            db_.insertIntoTable(
+            writeRow(
               table_name,
               {
                 { "term_id", word1 },
@@ -864,32 +1241,35 @@ namespace verbly {
           }
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readWordNetCausality()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_cs.pl"));
-      hatkirby::progress ppgs("Writing causality...", lines.size());
-      for (auto line : lines)
+      line_reader lines(wordNetPath_ + "wn_cs.pl");
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation("^cs\\((2\\d{8}),(2\\d{8})\\)\\.");
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "cs")
+          || (fact.getArgumentCount() != 2)
+          || !fact.isSynset(0, "2")
+          || !fact.isSynset(1, "2"))
         {
           continue;
         }
 
-        int lookup1 = std::stoi(relation_data[1]);
-        int lookup2 = std::stoi(relation_data[2]);
+        int lookup1 = fact.getInteger(0);
+        int lookup2 = fact.getInteger(1);
 
         if (notionByWnid_.count(lookup1) && notionByWnid_.count(lookup2))
         {
           notion& notion1 = *notionByWnid_.at(lookup1);
           notion& notion2 = *notionByWnid_.at(lookup2);
 
-          db_.insertIntoTable(
+          writeRow(
             "causality",
             {
               { "effect_id", notion1.getId() },
@@ -897,32 +1277,35 @@ namespace verbly {
             });
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readWordNetEntailment()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_ent.pl"));
-      hatkirby::progress ppgs("Writing entailment...", lines.size());
-      for (auto line : lines)
+      line_reader lines(wordNetPath_ + "wn_ent.pl");
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation("^ent\\((2\\d{8}),(2\\d{8})\\)\\.");
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "ent")
+          || (fact.getArgumentCount() != 2)
+          || !fact.isSynset(0, "2")
+          || !fact.isSynset(1, "2"))
         {
           continue;
         }
 
-        int lookup1 = std::stoi(relation_data[1]);
-        int lookup2 = std::stoi(relation_data[2]);
+        int lookup1 = fact.getInteger(0);
+        int lookup2 = fact.getInteger(1);
 
         if (notionByWnid_.count(lookup1) && notionByWnid_.count(lookup2))
         {
           notion& notion1 = *notionByWnid_.at(lookup1);
           notion& notion2 = *notionByWnid_.at(lookup2);
 
-          db_.insertIntoTable(
+          writeRow(
             "entailment",
             {
               { "given_id", notion1.getId() },
@@ -930,32 +1313,35 @@ namespace verbly {
             });
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readWordNetHypernymy()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_hyp.pl"));
-      hatkirby::progress ppgs("Writing hypernymy...", lines.size());
-      for (auto line : lines)
+      line_reader lines(wordNetPath_ + "wn_hyp.pl");
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation("^hyp\\(([12]\\d{8}),([12]\\d{8})\\)\\.");
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "hyp")
+          || (fact.getArgumentCount() != 2)
+          || !fact.isSynset(0, "12")
+          || !fact.isSynset(1, "12"))
         {
           continue;
         }
 
-        int lookup1 = std::stoi(relation_data[1]);
-        int lookup2 = std::stoi(relation_data[2]);
+        int lookup1 = fact.getInteger(0);
+        int lookup2 = fact.getInteger(1);
 
         if (notionByWnid_.count(lookup1) && notionByWnid_.count(lookup2))
         {
           notion& notion1 = *notionByWnid_.at(lookup1);
           notion& notion2 = *notionByWnid_.at(lookup2);
 
-          db_.insertIntoTable(
+          writeRow(
             "hypernymy",
             {
               { "hyponym_id", notion1.getId() },
@@ -963,32 +1349,35 @@ namespace verbly {
             });
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readWordNetInstantiation()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_ins.pl"));
-      hatkirby::progress ppgs("Writing instantiation...", lines.size());
-      for (auto line : lines)
+      line_reader lines(wordNetPath_ + "wn_ins.pl");
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation("^ins\\((1\\d{8}),(1\\d{8})\\)\\.");
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "ins")
+          || (fact.getArgumentCount() != 2)
+          || !fact.isSynset(0, "1")
+          || !fact.isSynset(1, "1"))
         {
           continue;
         }
 
-        int lookup1 = std::stoi(relation_data[1]);
-        int lookup2 = std::stoi(relation_data[2]);
+        int lookup1 = fact.getInteger(0);
+        int lookup2 = fact.getInteger(1);
 
         if (notionByWnid_.count(lookup1) && notionByWnid_.count(lookup2))
         {
           notion& notion1 = *notionByWnid_.at(lookup1);
           notion& notion2 = *notionByWnid_.at(lookup2);
 
-          db_.insertIntoTable(
+          writeRow(
             "instantiation",
             {
               { "instance_id", notion1.getId() },
@@ -996,32 +1385,35 @@ namespace verbly {
             });
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readWordNetMemberMeronymy()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_mm.pl"));
-      hatkirby::progress ppgs("Writing member meronymy...", lines.size());
-      for (auto line : lines)
+      line_reader lines(wordNetPath_ + "wn_mm.pl");
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation("^mm\\((1\\d{8}),(1\\d{8})\\)\\.");
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "mm")
+          || (fact.getArgumentCount() != 2)
+          || !fact.isSynset(0, "1")
+          || !fact.isSynset(1, "1"))
         {
           continue;
         }
 
-        int lookup1 = std::stoi(relation_data[1]);
-        int lookup2 = std::stoi(relation_data[2]);
+        int lookup1 = fact.getInteger(0);
+        int lookup2 = fact.getInteger(1);
 
         if (notionByWnid_.count(lookup1) && notionByWnid_.count(lookup2))
         {
           notion& notion1 = *notionByWnid_.at(lookup1);
           notion& notion2 = *notionByWnid_.at(lookup2);
 
-          db_.insertIntoTable(
+          writeRow(
             "member_meronymy",
             {
               { "holonym_id", notion1.getId() },
@@ -1029,32 +1421,35 @@ namespace verbly {
             });
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readWordNetPartMeronymy()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_mp.pl"));
-      hatkirby::progress ppgs("Writing part meronymy...", lines.size());
-      for (auto line : lines)
+      line_reader lines(wordNetPath_ + "wn_mp.pl");
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation("^mp\\((1\\d{8}),(1\\d{8})\\)\\.");
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "mp")
+          || (fact.getArgumentCount() != 2)
+          || !fact.isSynset(0, "1")
+          || !fact.isSynset(1, "1"))
         {
           continue;
         }
 
-        int lookup1 = std::stoi(relation_data[1]);
-        int lookup2 = std::stoi(relation_data[2]);
+        int lookup1 = fact.getInteger(0);
+        int lookup2 = fact.getInteger(1);
 
         if (notionByWnid_.count(lookup1) && notionByWnid_.count(lookup2))
         {
           notion& notion1 = *notionByWnid_.at(lookup1);
           notion& notion2 = *notionByWnid_.at(lookup2);
 
-          db_.insertIntoTable(
+          writeRow(
             "part_meronymy",
             {
               { "holonym_id", notion1.getId() },
@@ -1062,32 +1457,35 @@ namespace verbly {
             });
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readWordNetSubstanceMeronymy()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_ms.pl"));
-      hatkirby::progress ppgs("Writing substance meronymy...", lines.size());
-      for (auto line : lines)
+      line_reader lines(wordNetPath_ + "wn_ms.pl");
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation("^ms\\((1\\d{8}),(1\\d{8})\\)\\.");
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "ms")
+          || (fact.getArgumentCount() != 2)
+          || !fact.isSynset(0, "1")
+          || !fact.isSynset(1, "1"))
         {
           continue;
         }
 
-        int lookup1 = std::stoi(relation_data[1]);
-        int lookup2 = std::stoi(relation_data[2]);
+        int lookup1 = fact.getInteger(0);
+        int lookup2 = fact.getInteger(1);
 
         if (notionByWnid_.count(lookup1) && notionByWnid_.count(lookup2))
         {
           notion& notion1 = *notionByWnid_.at(lookup1);
           notion& notion2 = *notionByWnid_.at(lookup2);
 
-          db_.insertIntoTable(
+          writeRow(
             "substance_meronymy",
             {
               { "holonym_id", notion1.getId() },
@@ -1095,36 +1493,36 @@ namespace verbly {
             });
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readWordNetPertainymy()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_per.pl", true));
-
-      hatkirby::progress ppgs(
-        "Writing pertainymy and mannernymy...",
-        lines.size());
+      line_reader lines(wordNetPath_ + "wn_per.pl", true);
 
-      for (auto line : lines)
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation(
-          "^per\\(([34]\\d{8}),(\\d+),([13]\\d{8}),(\\d+)\\)\\.");
-
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "per")
+          || (fact.getArgumentCount() != 4)
+          || !fact.isSynset(0, "34")
+          || !fact.isInteger(1)
+          || !fact.isSynset(2, "13")
+          || !fact.isInteger(3))
         {
           continue;
         }
 
         std::pair<int, int> lookup1(
-          std::stoi(relation_data[1]),
-          std::stoi(relation_data[2]));
+          fact.getInteger(0),
+          fact.getInteger(1));
 
         std::pair<int, int> lookup2(
-          std::stoi(relation_data[3]),
-          std::stoi(relation_data[4]));
+          fact.getInteger(2),
+          fact.getInteger(3));
 
         if (wordByWnidAndWnum_.count(lookup1) &&
             wordByWnidAndWnum_.count(lookup2))
@@ -1135,7 +1533,7 @@ namespace verbly {
           if (word1.getNotion().getPartOfSpeech() ==
               part_of_speech::adjective)
           {
-            db_.insertIntoTable(
+            writeRow(
               "pertainymy",
               {
                 { "pertainym_id", word1.getId() },
@@ -1144,7 +1542,7 @@ namespace verbly {
           } else if (word1.getNotion().getPartOfSpeech() ==
                       part_of_speech::adverb)
           {
-            db_.insertIntoTable(
+            writeRow(
               "mannernymy",
               {
                 { "mannernym_id", word1.getId() },
@@ -1153,30 +1551,35 @@ namespace verbly {
           }
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readWordNetSpecification()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_sa.pl"));
-      hatkirby::progress ppgs("Writing specifications...", lines.size());
-      for (auto line : lines)
+      line_reader lines(wordNetPath_ + "wn_sa.pl");
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation("^sa\\((23\\d{8}),(\\d+),(23\\d{8}),(\\d+)\\)\\.");
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "sa")
+          || (fact.getArgumentCount() != 4)
+          || !fact.isSynset(0, "23")
+          || !fact.isInteger(1)
+          || !fact.isSynset(2, "23")
+          || !fact.isInteger(3))
         {
           continue;
         }
 
         std::pair<int, int> lookup1(
-          std::stoi(relation_data[1]),
-          std::stoi(relation_data[2]));
+          fact.getInteger(0),
+          fact.getInteger(1));
 
         std::pair<int, int> lookup2(
-          std::stoi(relation_data[3]),
-          std::stoi(relation_data[4]));
+          fact.getInteger(2),
+          fact.getInteger(3));
 
 
         if (wordByWnidAndWnum_.count(lookup1) &&
@@ -1185,7 +1588,7 @@ namespace verbly {
           word& word1 = *wordByWnidAndWnum_.at(lookup1);
           word& word2 = *wordByWnidAndWnum_.at(lookup2);
 
-          db_.insertIntoTable(
+          writeRow(
             "specification",
             {
               { "general_id", word1.getId() },
@@ -1193,32 +1596,35 @@ namespace verbly {
             });
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
     }
 
     void generator::readWordNetSimilarity()
     {
-      std::list<std::string> lines(readFile(wordNetPath_ + "wn_sim.pl"));
-      hatkirby::progress ppgs("Writing adjective similarity...", lines.size());
-      for (auto line : lines)
+      line_reader lines(wordNetPath_ + "wn_sim.pl");
+      prolog_fact fact;
+      std::string_view line;
+      while (lines.next(line))
       {
-        ppgs.update();
-
-        std::regex relation("^sim\\((3\\d{8}),(3\\d{8})\\)\\.");
-        std::smatch relation_data;
-        if (!std::regex_search(line, relation_data, relation))
+        if (!fact.parse(line)
+          || (fact.getPredicate() != "sim")
+          || (fact.getArgumentCount() != 2)
+          || !fact.isSynset(0, "3")
+          || !fact.isSynset(1, "3"))
         {
           continue;
         }
 
-        int lookup1 = std::stoi(relation_data[1]);
-        int lookup2 = std::stoi(relation_data[2]);
+        int lookup1 = fact.getInteger(0);
+        int lookup2 = fact.getInteger(1);
 
         if (notionByWnid_.count(lookup1) && notionByWnid_.count(lookup2))
         {
           notion& notion1 = *notionByWnid_.at(lookup1);
           notion& notion2 = *notionByWnid_.at(lookup2);
 
-          db_.insertIntoTable(
+          writeRow(
             "similarity",
             {
               { "adjective_1_id", notion1.getId() },
@@ -1226,6 +1632,79 @@ namespace verbly {
             });
         }
       }
+
+      task_graph::countLines(lines.getLineCount());
+    }
+
+    /**
+     * Forms and pronunciations are numbered in the order they are created,
+     * which scatters the forms of a lemma across the forms table whenever some
+     * of them come from a later phase, and leaves pronunciations in CMUDICT
+     * order. Since their tables are stored in ID order, this renumbers forms
+     * by the first lemma that uses them, and pronunciations by the first form
+     * that uses them, so that hydrating a word reads neighbouring rows. Forms
+     * used by a single lemma keep their order relative to each other. IDs are
+     * temporarily negated so that no two rows share a key during the update.
+     */
+    void generator::layoutDatabase()
+    {
+      std::list<std::string> queries = {
+        "CREATE TEMP TABLE form_layout ( \
+          new_id INTEGER PRIMARY KEY, \
+          old_id INTEGER NOT NULL UNIQUE)",
+        "INSERT INTO form_layout (old_id) \
+          SELECT forms.form_id FROM forms \
+          LEFT JOIN ( \
+            SELECT form_id, MIN(lemma_id) AS lemma_id FROM lemmas_forms \
+            GROUP BY form_id) AS owners \
+          ON owners.form_id = forms.form_id \
+          ORDER BY owners.lemma_id IS NULL, owners.lemma_id, forms.form_id",
+        "UPDATE forms SET form_id = \
+          -(SELECT new_id FROM form_layout WHERE old_id = form_id)",
+        "UPDATE forms SET form_id = -form_id",
+        "UPDATE lemmas_forms SET form_id = \
+          -(SELECT new_id FROM form_layout WHERE old_id = form_id)",
+        "UPDATE lemmas_forms SET form_id = -form_id",
+        "UPDATE forms_pronunciations SET form_id = \
+          -(SELECT new_id FROM form_layout WHERE old_id = form_id)",
+        "UPDATE forms_pronunciations SET form_id = -form_id",
+        "DROP TABLE form_layout",
+        "CREATE TEMP TABLE pronunciation_layout ( \
+          new_id INTEGER PRIMARY KEY, \
+          old_id INTEGER NOT NULL UNIQUE)",
+        "INSERT INTO pronunciation_layout (old_id) \
+          SELECT pronunciations.pronunciation_id FROM pronunciations \
+          LEFT JOIN ( \
+            SELECT pronunciation_id, MIN(form_id) AS form_id \
+            FROM forms_pronunciations \
+            GROUP BY pronunciation_id) AS owners \
+          ON owners.pronunciation_id = pronunciations.pronunciation_id \
+          ORDER BY owners.form_id IS NULL, owners.form_id, \
+            pronunciations.pronunciation_id",
+        "UPDATE pronunciations SET pronunciation_id = \
+          -(SELECT new_id FROM pronunciation_layout \
+            WHERE old_id = pronunciation_id)",
+        "UPDATE pronunciations SET pronunciation_id = -pronunciation_id",
+        "UPDATE forms_pronunciations SET pronunciation_id = \
+          -(SELECT new_id FROM pronunciation_layout \
+            WHERE old_id = pronunciation_id)",
+        "UPDATE forms_pronunciations SET pronunciation_id = -pronunciation_id",
+        "DROP TABLE pronunciation_layout"
+      };
+
+      for (std::string& query : queries)
+      {
+        tasks_.write([this, query] () {
+          db_.execute(query);
+        });
+      }
+    }
+
+    void generator::compactDatabase()
+    {
+      std::cout << "Compacting data..." << std::endl;
+
+      db_.execute("VACUUM");
     }
 
     void generator::analyzeDatabase()
@@ -1235,39 +1714,15 @@ namespace verbly {
       db_.execute("ANALYZE");
     }
 
-    std::list<std::string> generator::readFile(std::string path, bool uniq)
+    void generator::writeRow(
+      std::string table,
+      std::list<hatkirby::column> columns)
     {
-      std::ifstream file(path);
-      if (!file)
-      {
-        throw std::invalid_argument("Could not find file " + path);
-      }
+      task_graph::countRow(table);
 
-      std::list<std::string> lines;
-      std::string line;
-      while (std::getline(file, line))
-      {
-        if (line.back() == '\r')
-        {
-          line.pop_back();
-        }
-
-        lines.push_back(line);
-      }
-
-      if (uniq)
-      {
-        std::vector<std::string> uniq(std::begin(lines), std::end(lines));
-        lines.clear();
-
-        std::sort(std::begin(uniq), std::end(uniq));
-        std::unique_copy(
-          std::begin(uniq),
-          std::end(uniq),
-          std::back_inserter(lines));
-      }
-
-      return lines;
+      tasks_.write([this, table, columns] () {
+        db_.insertIntoTable(table, columns);
+      });
     }
 
     part_of_speech generator::partOfSpeechByWnid(int wnid)
@@ -1303,24 +1758,32 @@ namespace verbly {
 
     lemma& generator::lookupOrCreateLemma(std::string base_form)
     {
-      if (!lemmaByBaseForm_.count(base_form))
+      auto it = lemmaByBaseForm_.find(base_form);
+      if (it != std::end(lemmaByBaseForm_))
       {
-        lemmas_.emplace_back(lookupOrCreateForm(base_form));
-        lemmaByBaseForm_[base_form] = &lemmas_.back();
+        return *it->second;
       }
 
-      return *lemmaByBaseForm_.at(base_form);
+      lemmas_.emplace_back(lookupOrCreateForm(base_form));
+      lemma& l = lemmas_.back();
+      lemmaByBaseForm_.emplace(l.getBaseForm().getText(), &l);
+
+      return l;
     }
 
     form& generator::lookupOrCreateForm(std::string text)
     {
-      if (!formByText_.count(text))
+      auto it = formByText_.find(text);
+      if (it != std::end(formByText_))
       {
-        forms_.emplace_back(text);
-        formByText_[text] = &forms_.back();
+        return *it->second;
       }
 
-      return *formByText_[text];
+      forms_.emplace_back(std::move(text));
+      form& f = forms_.back();
+      formByText_.emplace(f.getText(), &f);
+
+      return f;
     }
 
     template <typename... Args> word& generator::createWord(Args&&... args)
@@ -1328,17 +1791,21 @@ namespace verbly {
       words_.emplace_back(std::forward<Args>(args)...);
       word& w = words_.back();
 
-      wordsByBaseForm_[w.getLemma().getBaseForm().getText()].insert(&w);
+      wordsByBaseForm_[w.getLemma().getBaseForm().getText()].push_back(&w);
 
       if (w.getNotion().hasWnid())
       {
-        wordsByWnid_[w.getNotion().getWnid()].insert(&w);
+        wordsByWnid_[w.getNotion().getWnid()].push_back(&w);
       }
 
       return w;
     }
 
-    void generator::createGroup(xmlNodePtr top, const group* parent)
+    /**
+     * The VerbNet data always defines subclasses after everything else in a
+     * class, so a subgroup can be created as a copy of its finished parent.
+     */
+    void generator::createGroup(const verbnet_class& vnc, const group* parent)
     {
       if (parent != nullptr)
       {
@@ -1349,254 +1816,116 @@ namespace verbly {
 
       group& grp = groups_.back();
 
-      xmlChar* key;
+      for (const verbnet_class::member& m : vnc.getMembers())
+      {
+        std::list<std::string> wnSenseKeys;
+
+        for (const std::string& sense : m.senseKeys)
+        {
+          std::string senseKey = sense + "::";
 
-      for (xmlNodePtr node = top->xmlChildrenNode; node != nullptr; node = node->next)
+          if (wnSenseKeys_.count(senseKey))
+          {
+            wnSenseKeys.push_back(std::move(senseKey));
+          }
+        }
+
+        if (!wnSenseKeys.empty())
+        {
+          for (std::string sense : wnSenseKeys)
+          {
+            word& wordSense = *wnSenseKeys_[sense];
+            wordSense.setVerbGroup(grp);
+          }
+        } else {
+          notion& n = createNotion(part_of_speech::verb);
+          lemma& l = lookupOrCreateLemma(m.name);
+          word& w = createWord(n, l);
+
+          w.setVerbGroup(grp);
+        }
+      }
+
+      for (const role& r : vnc.getRoles())
+      {
+        grp.addRole(r);
+      }
+
+      for (const auto& description : vnc.getFrames())
       {
-        if (!xmlStrcmp(node->name, reinterpret_cast<const xmlChar*>("SUBCLASSES")))
+        frame fr;
+
+        for (const verbnet_class::part_description& p : description)
         {
-          for (xmlNodePtr subclass = node->xmlChildrenNode; subclass != nullptr; subclass = subclass->next)
+          switch (p.type)
           {
-            if (!xmlStrcmp(subclass->name, reinterpret_cast<const xmlChar*>("VNSUBCLASS")))
+            case part_type::noun_phrase:
             {
-              try
-              {
-                // Parsing a subgroup starts by making a copy of everything in
-                // the parent. This is okay to do at this point because in the
-                // VerbNet data, subgroups are always defined after everything
-                // else.
-                createGroup(subclass, &grp);
-              } catch (const std::exception& e)
-              {
-                key = xmlGetProp(subclass, reinterpret_cast<const xmlChar*>("ID"));
+              fr.push_back(
+                part::createNounPhrase(p.value, p.selrestrs, p.synrestrs));
 
-                if (key == nullptr)
-                {
-                  std::throw_with_nested(std::logic_error("Error parsing IDless subgroup"));
-                } else {
-                  std::string subgroupId(reinterpret_cast<const char*>(key));
-                  xmlFree(key);
+              break;
+            }
 
-                  std::throw_with_nested(std::logic_error("Error parsing subgroup " + subgroupId));
-                }
-              }
+            case part_type::verb:
+            {
+              fr.push_back(part::createVerb());
+
+              break;
             }
-          }
-        } else if (!xmlStrcmp(node->name, reinterpret_cast<const xmlChar*>("MEMBERS")))
-        {
-          for (xmlNodePtr member = node->xmlChildrenNode; member != nullptr; member = member->next)
-          {
-            if (!xmlStrcmp(member->name, reinterpret_cast<const xmlChar*>("MEMBER")))
+
+            case part_type::preposition:
             {
-              key = xmlGetProp(member, reinterpret_cast<const xmlChar*>("wn"));
-              std::string wnSenses(reinterpret_cast<const char*>(key));
-              xmlFree(key);
+              fr.push_back(part::createPreposition(p.choices, p.literal));
 
-              auto wnSenseKeys =
-                hatkirby::split<std::list<std::string>>(wnSenses, " ");
+              break;
+            }
 
-              if (!wnSenseKeys.empty())
-              {
-                std::list<std::string> tempKeys;
-
-                std::transform(
-                  std::begin(wnSenseKeys),
-                  std::end(wnSenseKeys),
-                  std::back_inserter(tempKeys),
-                  [] (std::string sense) {
-                    return sense + "::";
-                  });
-
-                std::list<std::string> filteredKeys;
-
-                std::remove_copy_if(
-                  std::begin(tempKeys),
-                  std::end(tempKeys),
-                  std::back_inserter(filteredKeys),
-                  [&] (std::string sense) {
-                    return !wnSenseKeys_.count(sense);
-                  });
-
-                wnSenseKeys = std::move(filteredKeys);
-              }
+            case part_type::adjective:
+            {
+              fr.push_back(part::createAdjective());
 
-              if (!wnSenseKeys.empty())
-              {
-                for (std::string sense : wnSenseKeys)
-                {
-                  word& wordSense = *wnSenseKeys_[sense];
-                  wordSense.setVerbGroup(grp);
-                }
-              } else {
-                key = xmlGetProp(member, reinterpret_cast<const xmlChar*>("name"));
-                std::string memberName(reinterpret_cast<const char*>(key));
-                xmlFree(key);
+              break;
+            }
 
-                notion& n = createNotion(part_of_speech::verb);
-                lemma& l = lookupOrCreateLemma(memberName);
-                word& w = createWord(n, l);
+            case part_type::adverb:
+            {
+              fr.push_back(part::createAdverb());
 
-                w.setVerbGroup(grp);
-              }
+              break;
             }
-          }
-        } else if (!xmlStrcmp(node->name, reinterpret_cast<const xmlChar*>("THEMROLES")))
-        {
-          for (xmlNodePtr roletopnode = node->xmlChildrenNode; roletopnode != nullptr; roletopnode = roletopnode->next)
-          {
-            if (!xmlStrcmp(roletopnode->name, reinterpret_cast<const xmlChar*>("THEMROLE")))
+
+            case part_type::literal:
             {
-              key = xmlGetProp(roletopnode, reinterpret_cast<const xmlChar*>("type"));
-              std::string roleName = reinterpret_cast<const char*>(key);
-              xmlFree(key);
+              fr.push_back(part::createLiteral(p.value));
 
-              std::set<std::string> roleSelrestrs;
-              for (xmlNodePtr rolenode = roletopnode->xmlChildrenNode; rolenode != nullptr; rolenode = rolenode->next)
-              {
-                if (!xmlStrcmp(rolenode->name, reinterpret_cast<const xmlChar*>("SELRESTRS")))
-                {
-                  for (xmlNodePtr selrestrnode = rolenode->xmlChildrenNode; selrestrnode != nullptr; selrestrnode = selrestrnode->next)
-                  {
-                    if (!xmlStrcmp(selrestrnode->name, reinterpret_cast<const xmlChar*>("SELRESTR")))
-                    {
-                      key = xmlGetProp(selrestrnode, reinterpret_cast<const xmlChar*>("type"));
-                      roleSelrestrs.insert(std::string(reinterpret_cast<const char*>(key)));
-                      xmlFree(key);
-                    }
-                  }
-                }
-              }
+              break;
+            }
 
-              grp.addRole({roleName, std::move(roleSelrestrs)});
+            case part_type::invalid:
+            {
+              throw std::logic_error("Invalid VerbNet frame part");
             }
           }
-        } else if (!xmlStrcmp(node->name, reinterpret_cast<const xmlChar*>("FRAMES")))
+        }
+
+        grp.addFrame(std::move(fr));
+      }
+
+      for (const verbnet_class& subclass : vnc.getSubclasses())
+      {
+        try
         {
-          for (xmlNodePtr frametopnode = node->xmlChildrenNode; frametopnode != nullptr; frametopnode = frametopnode->next)
+          createGroup(subclass, &grp);
+        } catch (const std::exception& e)
+        {
+          if (subclass.getId().empty())
           {
-            if (!xmlStrcmp(frametopnode->name, reinterpret_cast<const xmlChar*>("FRAME")))
-            {
-              frame fr;
-
-              for (xmlNodePtr framenode = frametopnode->xmlChildrenNode; framenode != nullptr; framenode = framenode->next)
-              {
-                if (!xmlStrcmp(framenode->name, reinterpret_cast<const xmlChar*>("SYNTAX")))
-                {
-                  for (xmlNodePtr syntaxnode = framenode->xmlChildrenNode; syntaxnode != nullptr; syntaxnode = syntaxnode->next)
-                  {
-                    if (!xmlStrcmp(syntaxnode->name, reinterpret_cast<const xmlChar*>("NP")))
-                    {
-                      key = xmlGetProp(syntaxnode, reinterpret_cast<const xmlChar*>("value"));
-                      std::string partRole = reinterpret_cast<const char*>(key);
-                      xmlFree(key);
-
-                      std::set<std::string> partSelrestrs;
-                      std::set<std::string> partSynrestrs;
-
-                      for (xmlNodePtr npnode = syntaxnode->xmlChildrenNode; npnode != nullptr; npnode = npnode->next)
-                      {
-                        if (!xmlStrcmp(npnode->name, reinterpret_cast<const xmlChar*>("SYNRESTRS")))
-                        {
-                          for (xmlNodePtr synrestr = npnode->xmlChildrenNode; synrestr != nullptr; synrestr = synrestr->next)
-                          {
-                            if (!xmlStrcmp(synrestr->name, reinterpret_cast<const xmlChar*>("SYNRESTR")))
-                            {
-                              key = xmlGetProp(synrestr, reinterpret_cast<const xmlChar*>("type"));
-                              partSynrestrs.insert(reinterpret_cast<const char*>(key));
-                              xmlFree(key);
-                            }
-                          }
-                        } else if (!xmlStrcmp(npnode->name, reinterpret_cast<const xmlChar*>("SELRESTRS")))
-                        {
-                          for (xmlNodePtr selrestrnode = npnode->xmlChildrenNode; selrestrnode != nullptr; selrestrnode = selrestrnode->next)
-                          {
-                            if (!xmlStrcmp(selrestrnode->name, reinterpret_cast<const xmlChar*>("SELRESTR")))
-                            {
-                              key = xmlGetProp(selrestrnode, reinterpret_cast<const xmlChar*>("type"));
-                              partSelrestrs.insert(std::string(reinterpret_cast<const char*>(key)));
-                              xmlFree(key);
-                            }
-                          }
-                        }
-                      }
-
-                      fr.push_back(part::createNounPhrase(std::move(partRole), std::move(partSelrestrs), std::move(partSynrestrs)));
-                    } else if (!xmlStrcmp(syntaxnode->name, reinterpret_cast<const xmlChar*>("VERB")))
-                    {
-                      fr.push_back(part::createVerb());
-                    } else if (!xmlStrcmp(syntaxnode->name, reinterpret_cast<const xmlChar*>("PREP")))
-                    {
-                      std::set<std::string> partChoices;
-                      bool partLiteral;
-
-                      if (xmlHasProp(syntaxnode, reinterpret_cast<const xmlChar*>("value")))
-                      {
-                        partLiteral = true;
-
-                        key = xmlGetProp(syntaxnode, reinterpret_cast<const xmlChar*>("value"));
-                        std::string choicesStr = reinterpret_cast<const char*>(key);
-                        xmlFree(key);
-
-                        auto choices =
-                          hatkirby::split<std::list<std::string>>(
-                            choicesStr, " ");
-
-                        for (std::string choice : choices)
-                        {
-                          int chloc;
-                          while ((chloc = choice.find_first_of("_"))
-                                  != std::string::npos)
-                          {
-                            choice.replace(chloc, 1, " ");
-                          }
-
-                          partChoices.insert(std::move(choice));
-                        }
-                      } else {
-                        partLiteral = false;
-
-                        for (xmlNodePtr npnode = syntaxnode->xmlChildrenNode;
-                              npnode != nullptr;
-                              npnode = npnode->next)
-                        {
-                          if (!xmlStrcmp(npnode->name, reinterpret_cast<const xmlChar*>("SELRESTRS")))
-                          {
-                            for (xmlNodePtr synrestr = npnode->xmlChildrenNode; synrestr != nullptr; synrestr = synrestr->next)
-                            {
-                              if (!xmlStrcmp(synrestr->name, reinterpret_cast<const xmlChar*>("SELRESTR")))
-                              {
-                                key = xmlGetProp(synrestr, reinterpret_cast<const xmlChar*>("type"));
-                                partChoices.insert(reinterpret_cast<const char*>(key));
-                                xmlFree(key);
-                              }
-                            }
-                          }
-                        }
-                      }
-
-                      fr.push_back(part::createPreposition(std::move(partChoices), partLiteral));
-                    } else if (!xmlStrcmp(syntaxnode->name, reinterpret_cast<const xmlChar*>("ADJ")))
-                    {
-                      fr.push_back(part::createAdjective());
-                    } else if (!xmlStrcmp(syntaxnode->name, reinterpret_cast<const xmlChar*>("ADV")))
-                    {
-                      fr.push_back(part::createAdverb());
-                    } else if (!xmlStrcmp(syntaxnode->name, reinterpret_cast<const xmlChar*>("LEX")))
-                    {
-                      key = xmlGetProp(syntaxnode, reinterpret_cast<const xmlChar*>("value"));
-                      std::string literalValue = reinterpret_cast<const char*>(key);
-                      xmlFree(key);
-
-                      fr.push_back(part::createLiteral(literalValue));
-                    } else {
-                      continue;
-                    }
-                  }
-
-                  grp.addFrame(std::move(fr));
-                }
-              }
-            }
+            std::throw_with_nested(
+              std::logic_error("Error creating IDless subgroup"));
+          } else {
+            std::throw_with_nested(
+              std::logic_error("Error creating subgroup " + subclass.getId()));
           }
         }
       }
@@ -2,10 +2,11 @@
 #define GENERATOR_H_5B61CBC5
 
 #include <string>
-#include <map>
+#include <string_view>
 #include <list>
-#include <set>
-#include <libxml/parser.h>
+#include <deque>
+#include <vector>
+#include <unordered_map>
 #include <hkutil/database.h>
 #include "notion.h"
 #include "word.h"
@@ -14,6 +15,10 @@
 #include "pronunciation.h"
 #include "group.h"
 #include "frame.h"
+#include "verbnet_class.h"
+#include "stage_cache.h"
+#include "restriction_vocabulary.h"
+#include "task_graph.h"
 
 namespace verbly {
 
@@ -32,7 +37,8 @@ namespace verbly {
         std::string wordNetPath,
         std::string cmudictPath,
         std::string imageNetPath,
-        std::string outputPath);
+        std::string outputPath,
+        std::string cachePath = "");
 
       // Action
 
@@ -52,6 +58,8 @@ namespace verbly {
 
       void readVerbNet();
 
+      void createVerbNetGroups();
+
       void readAgidInflections();
 
       void readPrepositions();
@@ -60,6 +68,8 @@ namespace verbly {
 
       void writeSchema();
 
+      void writeIndexes();
+
       void writeVersion();
 
       void dumpObjects();
@@ -90,11 +100,19 @@ namespace verbly {
 
       void readWordNetSimilarity();
 
+      void layoutDatabase();
+
+      void compactDatabase();
+
       void analyzeDatabase();
 
       // Helpers
 
-      std::list<std::string> readFile(std::string path, bool uniq = false);
+      void runPhase(std::string name, void (generator::*phase)());
+
+      void writeProfile(double elapsed);
+
+      void writeRow(std::string table, std::list<hatkirby::column> columns);
 
       inline part_of_speech partOfSpeechByWnid(int wnid);
 
@@ -108,7 +126,9 @@ namespace verbly {
 
       template <typename... Args> word& createWord(Args&&... args);
 
-      void createGroup(xmlNodePtr top, const group* parent = nullptr);
+      void createGroup(
+        const verbnet_class& vnc,
+        const group* parent = nullptr);
 
       // Input
 
@@ -118,32 +138,55 @@ namespace verbly {
       std::string cmudictPath_;
       std::string imageNetPath_;
 
+      // Cache
+
+      stage_cache cache_;
+
       // Output
 
+      std::string outputPath_;
       hatkirby::database db_;
+      task_graph tasks_;
+      std::list<std::string> indexQueries_;
+      std::list<task_graph::profile> phaseProfiles_;
+      restriction_vocabulary restrictions_;
 
       // Data
 
-      std::list<notion> notions_;
-      std::list<word> words_;
-      std::list<lemma> lemmas_;
-      std::list<form> forms_;
-      std::list<pronunciation> pronunciations_;
-      std::list<group> groups_;
+      std::deque<notion> notions_;
+      std::deque<word> words_;
+      std::deque<lemma> lemmas_;
+      std::deque<form> forms_;
+      std::deque<pronunciation> pronunciations_;
+      std::deque<group> groups_;
+      std::vector<verbnet_class> verbNetClasses_;
 
       // Indexes
 
-      std::map<int, notion*> notionByWnid_;
-      std::map<int, std::set<word*>> wordsByWnid_;
-      std::map<std::pair<int, int>, word*> wordByWnidAndWnum_;
-      std::map<std::string, std::set<word*>> wordsByBaseForm_;
-      std::map<std::string, lemma*> lemmaByBaseForm_;
-      std::map<std::string, form*> formByText_;
-      std::map<std::string, pronunciation*> pronunciationByPhonemes_;
+      // Hashes a synset ID together with a word number
+      struct wnum_hash {
+        size_t operator()(const std::pair<int, int>& key) const
+        {
+          return std::hash<unsigned long long>()(
+            (static_cast<unsigned long long>(key.first) << 32)
+              | static_cast<unsigned int>(key.second));
+        }
+      };
+
+      // The string keys are views of the text stored in the objects that the
+      // indexes point to. Objects are never moved or destroyed after they are
+      // created, so the views stay valid, and no text is stored twice.
+      std::unordered_map<int, notion*> notionByWnid_;
+      std::unordered_map<int, std::vector<word*>> wordsByWnid_;
+      std::unordered_map<std::pair<int, int>, word*, wnum_hash> wordByWnidAndWnum_;
+      std::unordered_map<std::string_view, std::vector<word*>> wordsByBaseForm_;
+      std::unordered_map<std::string_view, lemma*> lemmaByBaseForm_;
+      std::unordered_map<std::string_view, form*> formByText_;
+      std::unordered_map<std::string_view, pronunciation*> pronunciationByPhonemes_;
 
       // Caches
 
-      std::map<std::string, word*> wnSenseKeys_;
+      std::unordered_map<std::string, word*> wnSenseKeys_;
 
     };
 
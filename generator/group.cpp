@@ -3,6 +3,8 @@
 #include <list>
 #include <hkutil/string.h>
 #include "frame.h"
+#include "restriction_vocabulary.h"
+#include "task_graph.h"
 
 namespace verbly {
   namespace generator {
@@ -48,12 +50,17 @@ namespace verbly {
       return roles_.at(name);
     }
 
-    hatkirby::database& operator<<(hatkirby::database& db, const group& arg)
+    void serializeGroup(
+      hatkirby::database& db,
+      const group& arg,
+      restriction_vocabulary& restrictions)
     {
       // Serialize each frame
       for (const frame& f : arg.getFrames())
       {
         // First, serialize the group/frame relationship
+        task_graph::countRow("frames");
+
         db.insertIntoTable(
           "frames",
           {
@@ -88,6 +95,8 @@ namespace verbly {
 
               for (const std::string& s : partSelrestrs)
               {
+                task_graph::countRow("selrestrs");
+
                 db.insertIntoTable(
                   "selrestrs",
                   {
@@ -99,6 +108,8 @@ namespace verbly {
               // Short interlude to serialize the synrestrs
               for (const std::string& s : p.getNounSynrestrs())
               {
+                task_graph::countRow("synrestrs");
+
                 db.insertIntoTable(
                   "synrestrs",
                   {
@@ -107,6 +118,16 @@ namespace verbly {
                   });
               }
 
+              // The part also stores both sets as interned bitmasks, which is
+              // how the library reads them.
+              fields.emplace_back("selrestrs",
+                serializeRestrictions(
+                  restrictions.internSelrestrs(db, partSelrestrs)));
+
+              fields.emplace_back("synrestrs",
+                serializeRestrictions(
+                  restrictions.internSynrestrs(db, p.getNounSynrestrs())));
+
               break;
             }
 
@@ -151,11 +172,11 @@ namespace verbly {
             }
           }
 
+          task_graph::countRow("parts");
+
           db.insertIntoTable("parts", std::move(fields));
         }
       }
-
-      return db;
     }
 
   };
@@ -12,6 +12,7 @@ namespace verbly {
   namespace generator {
 
     class frame;
+    class restriction_vocabulary;
 
     class group {
     public:
@@ -66,7 +67,12 @@ namespace verbly {
 
     // Serializer
 
-    hatkirby::database& operator<<(hatkirby::database& db, const group& arg);
+    // Restriction names are interned in the given vocabulary, which should be
+    // shared by every group written to the same datafile.
+    void serializeGroup(
+      hatkirby::database& db,
+      const group& arg,
+      restriction_vocabulary& restrictions);
 
   };
 };
@@ -2,6 +2,7 @@
 #include <list>
 #include <stdexcept>
 #include "form.h"
+#include "task_graph.h"
 
 namespace verbly {
   namespace generator {
@@ -49,6 +50,8 @@ namespace verbly {
       {
         for (const form* f : arg.getInflections(type))
         {
+          task_graph::countRow("lemmas_forms");
+
           db.insertIntoTable(
             "lemmas_forms",
             {
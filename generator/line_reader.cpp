@@ -0,0 +1,99 @@
+#include "line_reader.h"
+#include <stdexcept>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace verbly {
+  namespace generator {
+
+    line_reader::line_reader(
+      const std::string& path,
+      bool uniq) :
+        uniq_(uniq)
+    {
+      int fd = open(path.c_str(), O_RDONLY);
+      if (fd == -1)
+      {
+        throw std::invalid_argument("Could not find file " + path);
+      }
+
+      struct stat info;
+      if (fstat(fd, &info) == -1)
+      {
+        close(fd);
+
+        throw std::runtime_error("Could not read file " + path);
+      }
+
+      size_ = info.st_size;
+
+      // An empty file cannot be mapped, but also has no lines to read.
+      if (size_ > 0)
+      {
+        void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping == MAP_FAILED)
+        {
+          close(fd);
+
+          throw std::runtime_error("Could not map file " + path);
+        }
+
+        madvise(mapping, size_, MADV_SEQUENTIAL);
+
+        data_ = static_cast<const char*>(mapping);
+      }
+
+      // The mapping stays valid after the descriptor is closed.
+      close(fd);
+    }
+
+    line_reader::~line_reader()
+    {
+      if (data_)
+      {
+        munmap(const_cast<char*>(data_), size_);
+      }
+    }
+
+    bool line_reader::next(std::string_view& line)
+    {
+      while (position_ < size_)
+      {
+        const char* start = data_ + position_;
+        const char* newline =
+          static_cast<const char*>(
+            std::memchr(start, '\n', size_ - position_));
+
+        size_t length;
+        if (newline)
+        {
+          length = newline - start;
+          position_ += length + 1;
+        } else {
+          length = size_ - position_;
+          position_ = size_;
+        }
+
+        if ((length > 0) && (start[length - 1] == '\r'))
+        {
+          length--;
+        }
+
+        line = std::string_view(start, length);
+        lineCount_++;
+
+        if (!uniq_ || seen_.insert(line).second)
+        {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+  };
+};
@@ -0,0 +1,75 @@
+#ifndef LINE_READER_H_ED0FCB9A
+#define LINE_READER_H_ED0FCB9A
+
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace verbly {
+  namespace generator {
+
+    /**
+     * Reads the lines of a file by mapping it into memory, so that the file
+     * does not need to be copied into a string per line before it can be
+     * processed. Lines are returned as views into the mapping, without their
+     * line endings, and are only valid while the reader is alive.
+     *
+     * If uniq is true, a line that is identical to an earlier line is skipped.
+     */
+    class line_reader {
+    public:
+
+      // Constructor
+
+      explicit line_reader(const std::string& path, bool uniq = false);
+
+      // Disallow copying
+
+      line_reader(const line_reader& other) = delete;
+      line_reader& operator=(const line_reader& other) = delete;
+
+      // Destructor
+
+      ~line_reader();
+
+      // Reading
+
+      // Reads the next line, returning false at the end of the file.
+      bool next(std::string_view& line);
+
+      // Progress
+
+      // The size of the file, in bytes.
+      size_t getSize() const
+      {
+        return size_;
+      }
+
+      // The number of bytes that have been read so far.
+      size_t getPosition() const
+      {
+        return position_;
+      }
+
+      // The number of lines that have been read so far, including skipped
+      // duplicates.
+      size_t getLineCount() const
+      {
+        return lineCount_;
+      }
+
+    private:
+
+      const char* data_ = nullptr;
+      size_t size_ = 0;
+      size_t position_ = 0;
+      size_t lineCount_ = 0;
+
+      bool uniq_;
+      std::unordered_set<std::string_view> seen_;
+    };
+
+  };
+};
+
+#endif /* end of include guard: LINE_READER_H_ED0FCB9A */
@@ -1,4 +1,5 @@
 #include "notion.h"
+#include "task_graph.h"
 
 namespace verbly {
   namespace generator {
@@ -62,6 +63,8 @@ namespace verbly {
           }
         }
 
+        task_graph::countRow("notions");
+
         db.insertIntoTable("notions", std::move(fields));
       }
 
@@ -70,6 +73,8 @@ namespace verbly {
       {
         for (std::string group : arg.getPrepositionGroups())
         {
+          task_graph::countRow("is_a");
+
           db.insertIntoTable(
             "is_a",
             {
@@ -0,0 +1,158 @@
+#include "prolog_fact.h"
+#include <stdexcept>
+#include <cctype>
+
+namespace verbly {
+  namespace generator {
+
+    bool prolog_fact::parse(std::string_view line)
+    {
+      argCount_ = 0;
+
+      size_t pos = 0;
+      while ((pos < line.size())
+        && (std::isalnum(static_cast<unsigned char>(line[pos]))
+          || (line[pos] == '_')))
+      {
+        pos++;
+      }
+
+      if ((pos == 0) || (pos >= line.size()) || (line[pos] != '('))
+      {
+        return false;
+      }
+
+      predicate_ = line.substr(0, pos);
+      pos++;
+
+      for (;;)
+      {
+        if ((pos >= line.size()) || (argCount_ == maxArguments))
+        {
+          return false;
+        }
+
+        argument& arg = args_[argCount_];
+        arg = argument();
+
+        if (line[pos] == '\'')
+        {
+          // A quoted string ends at the first quote that is not doubled.
+          size_t start = ++pos;
+
+          for (;;)
+          {
+            pos = line.find('\'', pos);
+
+            if (pos == std::string_view::npos)
+            {
+              return false;
+            }
+
+            if ((pos + 1 < line.size()) && (line[pos + 1] == '\''))
+            {
+              arg.hasEscapes = true;
+              pos += 2;
+            } else {
+              break;
+            }
+          }
+
+          arg.text = line.substr(start, pos - start);
+          pos++;
+        } else {
+          size_t start = pos;
+          bool digits = true;
+
+          while ((pos < line.size())
+            && (line[pos] != ',')
+            && (line[pos] != ')'))
+          {
+            if (!std::isdigit(static_cast<unsigned char>(line[pos])))
+            {
+              digits = false;
+            }
+
+            pos++;
+          }
+
+          if (pos == start)
+          {
+            return false;
+          }
+
+          arg.text = line.substr(start, pos - start);
+
+          if (digits && (arg.text.size() <= 9))
+          {
+            arg.isInteger = true;
+
+            for (char ch : arg.text)
+            {
+              arg.value = (arg.value * 10) + (ch - '0');
+            }
+          }
+        }
+
+        argCount_++;
+
+        if (pos >= line.size())
+        {
+          return false;
+        }
+
+        if (line[pos] == ',')
+        {
+          pos++;
+        } else if (line[pos] == ')')
+        {
+          pos++;
+
+          break;
+        } else {
+          return false;
+        }
+      }
+
+      return ((pos < line.size()) && (line[pos] == '.'));
+    }
+
+    int prolog_fact::getInteger(size_t index) const
+    {
+      const argument& arg = args_.at(index);
+
+      if (!arg.isInteger)
+      {
+        throw std::domain_error("Prolog argument is not an integer");
+      }
+
+      return arg.value;
+    }
+
+    std::string prolog_fact::getString(size_t index) const
+    {
+      const argument& arg = args_.at(index);
+
+      if (!arg.hasEscapes)
+      {
+        return std::string(arg.text);
+      }
+
+      std::string result;
+      result.reserve(arg.text.size());
+
+      for (size_t i = 0; i < arg.text.size(); i++)
+      {
+        result.push_back(arg.text[i]);
+
+        if (arg.text[i] == '\'')
+        {
+          i++;
+        }
+      }
+
+      return result;
+    }
+
+  };
+};
@@ -0,0 +1,87 @@
+#ifndef PROLOG_FACT_H_E669AFFA
+#define PROLOG_FACT_H_E669AFFA
+
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace verbly {
+  namespace generator {
+
+    /**
+     * A single fact from one of the WordNet Prolog files, such as
+     * s(100001740,1,'entity',n,1,11). Parsing a line does not allocate: the
+     * predicate and arguments refer back into the line, which must outlive
+     * the fact. Arguments are integers, unquoted atoms, or quoted strings in
+     * which a quote is escaped by doubling it.
+     */
+    class prolog_fact {
+    public:
+
+      // Parsing
+
+      // Returns false if the line is not a well-formed fact.
+      bool parse(std::string_view line);
+
+      // Accessors
+
+      std::string_view getPredicate() const
+      {
+        return predicate_;
+      }
+
+      size_t getArgumentCount() const
+      {
+        return argCount_;
+      }
+
+      bool isInteger(size_t index) const
+      {
+        return args_.at(index).isInteger;
+      }
+
+      int getInteger(size_t index) const;
+
+      // Returns an atom, or the contents of a quoted string with its escaped
+      // quotes undoubled.
+      std::string getString(size_t index) const;
+
+      // Returns whether an argument is a synset ID, which is nine digits long
+      // and starts with a digit giving the synset's part of speech. The digit
+      // must be one of the given ones.
+      bool isSynset(size_t index, std::string_view types) const
+      {
+        const argument& arg = args_.at(index);
+
+        return arg.isInteger
+          && (arg.text.size() == 9)
+          && (types.find(arg.text[0]) != std::string_view::npos);
+      }
+
+      // Returns the text of an argument as it appears in the line, without
+      // the quotes around a quoted string.
+      std::string_view getRaw(size_t index) const
+      {
+        return args_.at(index).text;
+      }
+
+    private:
+
+      static const size_t maxArguments = 8;
+
+      struct argument {
+        std::string_view text;
+        bool isInteger = false;
+        bool hasEscapes = false;
+        int value = 0;
+      };
+
+      std::string_view predicate_;
+      std::array<argument, maxArguments> args_;
+      size_t argCount_ = 0;
+    };
+
+  };
+};
+
+#endif /* end of include guard: PROLOG_FACT_H_E669AFFA */
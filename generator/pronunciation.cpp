@@ -1,58 +1,68 @@
 #include "pronunciation.h"
 #include <list>
+#include <vector>
+#include <string_view>
 #include <algorithm>
 #include <cctype>
 #include <iterator>
-#include <hkutil/string.h>
+#include "task_graph.h"
 
 namespace verbly {
   namespace generator {
 
     int pronunciation::nextId_ = 0;
 
+    /**
+     * The phonemes are scanned as views into the phoneme string, rather than
+     * being split into a string each, since this runs once for every distinct
+     * pronunciation in CMUDICT.
+     */
     pronunciation::pronunciation(std::string phonemes) :
       id_(nextId_++),
-      phonemes_(phonemes)
+      phonemes_(std::move(phonemes))
     {
-      auto phonemeList =
-        hatkirby::split<std::list<std::string>>(phonemes, " ");
+      std::vector<std::string_view> phonemeList;
 
-      std::list<std::string>::iterator rhymeStart =
+      std::string_view remaining(phonemes_);
+      while (!remaining.empty())
+      {
+        size_t divider = remaining.find(' ');
+        phonemeList.push_back(remaining.substr(0, divider));
+
+        if (divider == std::string_view::npos)
+        {
+          remaining = {};
+        } else {
+          remaining.remove_prefix(divider + 1);
+        }
+      }
+
+      auto rhymeStart =
         std::find_if(
           std::begin(phonemeList),
           std::end(phonemeList),
-          [] (std::string phoneme) {
-            return phoneme.find("1") != std::string::npos;
+          [] (std::string_view phoneme) {
+            return phoneme.find('1') != std::string_view::npos;
           });
 
       // Rhyme detection
       if (rhymeStart != std::end(phonemeList))
       {
-        std::list<std::string> rhymePhonemes;
-
-        std::transform(
-          rhymeStart,
-          std::end(phonemeList),
-          std::back_inserter(rhymePhonemes),
-          [] (std::string phoneme) {
-            std::string naked;
-
-            std::remove_copy_if(
-              std::begin(phoneme),
-              std::end(phoneme),
-              std::back_inserter(naked),
-              [] (char ch) {
-                return std::isdigit(ch);
-              });
-
-            return naked;
-          });
+        for (auto it = rhymeStart; it != std::end(phonemeList); it++)
+        {
+          if (it != rhymeStart)
+          {
+            rhyme_.push_back(' ');
+          }
 
-        rhyme_ =
-          hatkirby::implode(
-            std::begin(rhymePhonemes),
-            std::end(rhymePhonemes),
-            " ");
+          std::remove_copy_if(
+            std::begin(*it),
+            std::end(*it),
+            std::back_inserter(rhyme_),
+            [] (char ch) {
+              return std::isdigit(ch);
+            });
+        }
 
         if (rhymeStart != std::begin(phonemeList))
         {
@@ -61,9 +71,9 @@ namespace verbly {
       }
 
       // Syllable/stress
-      for (std::string phoneme : phonemeList)
+      for (std::string_view phoneme : phonemeList)
       {
-        if (std::isdigit(phoneme.back()))
+        if (!phoneme.empty() && std::isdigit(phoneme.back()))
         {
           // It's a vowel!
           syllables_++;
@@ -95,6 +105,8 @@ namespace verbly {
         fields.emplace_back("prerhyme", arg.getPrerhyme());
       }
 
+      task_graph::countRow("pronunciations");
+
       db.insertIntoTable("pronunciations", std::move(fields));
 
       return db;
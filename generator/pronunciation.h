@@ -22,7 +22,7 @@ namespace verbly {
         return id_;
       }
 
-      std::string getPhonemes() const
+      const std::string& getPhonemes() const
       {
         return phonemes_;
       }
@@ -0,0 +1,60 @@
+#include "restriction_vocabulary.h"
+#include <stdexcept>
+#include "task_graph.h"
+
+namespace verbly {
+  namespace generator {
+
+    restriction_set restriction_vocabulary::internSelrestrs(
+      hatkirby::database& db,
+      const std::set<std::string>& names)
+    {
+      return intern(db, selrestrBits_, "selrestr_names", names);
+    }
+
+    restriction_set restriction_vocabulary::internSynrestrs(
+      hatkirby::database& db,
+      const std::set<std::string>& names)
+    {
+      return intern(db, synrestrBits_, "synrestr_names", names);
+    }
+
+    restriction_set restriction_vocabulary::intern(
+      hatkirby::database& db,
+      std::map<std::string, int>& bits,
+      const std::string& table,
+      const std::set<std::string>& names)
+    {
+      restriction_set result;
+
+      for (const std::string& name : names)
+      {
+        if (!bits.count(name))
+        {
+          int bit = bits.size();
+
+          if (bit >= static_cast<int>(result.size()))
+          {
+            throw std::length_error("Too many distinct restrictions in " + table);
+          }
+
+          task_graph::countRow(table);
+
+          db.insertIntoTable(
+            table,
+            {
+              { "bit", bit },
+              { "name", name }
+            });
+
+          bits[name] = bit;
+        }
+
+        result.set(bits.at(name));
+      }
+
+      return result;
+    }
+
+  };
+};
@@ -0,0 +1,47 @@
+#ifndef RESTRICTION_VOCABULARY_H_2B94E0C7
+#define RESTRICTION_VOCABULARY_H_2B94E0C7
+
+#include <map>
+#include <set>
+#include <string>
+#include <hkutil/database.h>
+#include "../lib/restriction.h"
+
+namespace verbly {
+  namespace generator {
+
+    /**
+     * Assigns a bit to each distinct selectional and syntactic restriction
+     * name in a datafile. The first time a name is interned, it is given the
+     * next unused bit, and the assignment is written to the datafile's
+     * selrestr_names or synrestr_names table.
+     */
+    class restriction_vocabulary {
+    public:
+
+      // Interning
+
+      restriction_set internSelrestrs(
+        hatkirby::database& db,
+        const std::set<std::string>& names);
+
+      restriction_set internSynrestrs(
+        hatkirby::database& db,
+        const std::set<std::string>& names);
+
+    private:
+
+      static restriction_set intern(
+        hatkirby::database& db,
+        std::map<std::string, int>& bits,
+        const std::string& table,
+        const std::set<std::string>& names);
+
+      std::map<std::string, int> selrestrBits_;
+      std::map<std::string, int> synrestrBits_;
+    };
+
+  };
+};
+
+#endif /* end of include guard: RESTRICTION_VOCABULARY_H_2B94E0C7 */
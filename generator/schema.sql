@@ -209,7 +209,9 @@ CREATE TABLE `parts` (
   `role` VARCHAR(16),
   `prepositions` BLOB,
   `preposition_literality` SMALLINT,
-  `literal_value` VARCHAR(64)
+  `literal_value` VARCHAR(64),
+  `selrestrs` BLOB,
+  `synrestrs` BLOB
 );
 
 CREATE INDEX `parts_of` ON `parts`(`frame_id`);
@@ -228,3 +230,13 @@ CREATE TABLE `selrestrs` (
 );
 
 CREATE INDEX `selrestrs_for` ON `selrestrs`(`part_id`);
+
+CREATE TABLE `synrestr_names` (
+  `bit` SMALLINT PRIMARY KEY,
+  `name` VARCHAR(32) NOT NULL
+);
+
+CREATE TABLE `selrestr_names` (
+  `bit` SMALLINT PRIMARY KEY,
+  `name` VARCHAR(32) NOT NULL
+);
@@ -0,0 +1,212 @@
+#include "stage_cache.h"
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <sys/stat.h>
+
+namespace verbly {
+  namespace generator {
+
+    namespace {
+
+      // Changing the format of a cache file should change this, so that old
+      // files are reparsed rather than misread.
+      const std::string cacheHeader = "verbly generator stage cache 1";
+
+      void writeSize(std::ostream& out, uint32_t size)
+      {
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+      }
+
+      bool readSize(const std::string& data, size_t& pos, uint32_t& size)
+      {
+        if (data.size() - pos < sizeof(size))
+        {
+          return false;
+        }
+
+        std::memcpy(&size, data.data() + pos, sizeof(size));
+        pos += sizeof(size);
+
+        return true;
+      }
+
+    };
+
+    stage_cache::stage_cache(std::string directory) :
+      directory_(std::move(directory))
+    {
+      if (directory_.empty())
+      {
+        return;
+      }
+
+      if ((mkdir(directory_.c_str(), 0755) == -1) && (errno != EEXIST))
+      {
+        throw std::invalid_argument(
+          "Could not create cache directory " + directory_);
+      }
+
+      if ((directory_.back() != '/') && (directory_.back() != '\\'))
+      {
+        directory_ += '/';
+      }
+    }
+
+    std::vector<stage_cache::record> stage_cache::fetch(
+      const std::string& stage,
+      int version,
+      const std::string& input,
+      const std::function<std::vector<record>()>& parse) const
+    {
+      if (directory_.empty())
+      {
+        return parse();
+      }
+
+      std::string path = directory_ + stage + ".cache";
+      std::string print = fingerprint(version, input);
+
+      std::vector<record> records;
+      if (load(path, print, records))
+      {
+        std::cout << "Reusing cached " << stage << "." << std::endl;
+
+        return records;
+      }
+
+      records = parse();
+      save(path, print, records);
+
+      return records;
+    }
+
+    std::string stage_cache::fingerprint(
+      int version,
+      const std::string& input) const
+    {
+      struct stat info;
+      if (stat(input.c_str(), &info) == -1)
+      {
+        throw std::invalid_argument("Could not find file " + input);
+      }
+
+      std::ostringstream print;
+      print << version
+        << " " << input
+        << " " << info.st_size
+        << " " << info.st_mtim.tv_sec
+        << " " << info.st_mtim.tv_nsec;
+
+      return print.str();
+    }
+
+    /**
+     * A cache file is the header and the fingerprint, each on its own line,
+     * followed by the records. Each record is its number of fields, and then
+     * the length and bytes of each field. Anything unexpected just means the
+     * stage is parsed again.
+     */
+    bool stage_cache::load(
+      const std::string& path,
+      const std::string& print,
+      std::vector<record>& records) const
+    {
+      std::ifstream file(path, std::ios::binary);
+      if (!file)
+      {
+        return false;
+      }
+
+      std::string header;
+      std::string savedPrint;
+      if (!std::getline(file, header)
+        || (header != cacheHeader)
+        || !std::getline(file, savedPrint)
+        || (savedPrint != print))
+      {
+        return false;
+      }
+
+      std::string data(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+
+      size_t pos = 0;
+      while (pos < data.size())
+      {
+        uint32_t fieldCount;
+        if (!readSize(data, pos, fieldCount))
+        {
+          return false;
+        }
+
+        record r;
+        r.reserve(fieldCount);
+
+        for (uint32_t i = 0; i < fieldCount; i++)
+        {
+          uint32_t length;
+          if (!readSize(data, pos, length) || (data.size() - pos < length))
+          {
+            return false;
+          }
+
+          r.emplace_back(data, pos, length);
+          pos += length;
+        }
+
+        records.push_back(std::move(r));
+      }
+
+      return true;
+    }
+
+    void stage_cache::save(
+      const std::string& path,
+      const std::string& print,
+      const std::vector<record>& records) const
+    {
+      // The file is written under a temporary name and then moved into place,
+      // so that an interrupted run cannot leave a truncated cache behind.
+      std::string tempPath = path + ".tmp";
+
+      {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+          throw std::runtime_error("Could not write cache file " + tempPath);
+        }
+
+        file << cacheHeader << '\n' << print << '\n';
+
+        for (const record& r : records)
+        {
+          writeSize(file, r.size());
+
+          for (const std::string& field : r)
+          {
+            writeSize(file, field.size());
+            file.write(field.data(), field.size());
+          }
+        }
+
+        if (!file)
+        {
+          throw std::runtime_error("Could not write cache file " + tempPath);
+        }
+      }
+
+      if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+      {
+        throw std::runtime_error("Could not write cache file " + path);
+      }
+    }
+
+  };
+};
@@ -0,0 +1,72 @@
+#ifndef STAGE_CACHE_H_61B0E7D3
+#define STAGE_CACHE_H_61B0E7D3
+
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace verbly {
+  namespace generator {
+
+    /**
+     * Keeps the parsed contents of the generator's input files between runs.
+     * A stage's records are saved along with a fingerprint made of the
+     * version of the stage's parser and the path, size, and modification time
+     * of the input file they were parsed from, and the file is only parsed
+     * again once that fingerprint changes. If no directory is given, nothing
+     * is cached and every stage is parsed.
+     *
+     * Only the ImageNet, AGID, and CMUDICT stages are cached. WordNet synsets
+     * and VerbNet classes are always parsed, since loading them from a cache
+     * was measured to be no faster than parsing them, and the model and the
+     * datafile are always rebuilt.
+     *
+     * This makes rebuilds faster, but it does not make them incremental. The
+     * prepositions are read after AGID and before CMUDICT, and object IDs are
+     * handed out in the order objects are created, so an edit to
+     * prepositions.txt changes the IDs of everything created after it. An edit
+     * to it, or to the VerbNet data, still parses WordNet and VerbNet again
+     * and writes the whole datafile.
+     */
+    class stage_cache {
+    public:
+
+      using record = std::vector<std::string>;
+
+      // Constructor
+
+      explicit stage_cache(std::string directory = "");
+
+      // Caching
+
+      // Returns the records for a stage, loading them from the cache if
+      // neither the input nor the parser's version has changed, and otherwise
+      // calling parse and saving what it returns. Safe to call for different
+      // stages at the same time.
+      std::vector<record> fetch(
+        const std::string& stage,
+        int version,
+        const std::string& input,
+        const std::function<std::vector<record>()>& parse) const;
+
+    private:
+
+      std::string fingerprint(int version, const std::string& input) const;
+
+      bool load(
+        const std::string& path,
+        const std::string& print,
+        std::vector<record>& records) const;
+
+      void save(
+        const std::string& path,
+        const std::string& print,
+        const std::vector<record>& records) const;
+
+      std::string directory_;
+    };
+
+  };
+};
+
+#endif /* end of include guard: STAGE_CACHE_H_61B0E7D3 */
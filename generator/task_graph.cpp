@@ -0,0 +1,403 @@
+#include "task_graph.h"
+#include <stdexcept>
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <ctime>
+#include <sys/resource.h>
+
+namespace verbly {
+  namespace generator {
+
+    namespace {
+
+      double threadCpuTime()
+      {
+        struct timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+
+        return now.tv_sec + (now.tv_nsec / 1000000000.0);
+      }
+
+      // On Linux, the maximum resident set size is measured in kilobytes.
+      long peakMemory()
+      {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == -1)
+        {
+          return 0;
+        }
+
+        return usage.ru_maxrss;
+      }
+
+    };
+
+    thread_local task_graph::profile* task_graph::current_ = nullptr;
+    thread_local std::map<std::string, size_t>* task_graph::rows_ = nullptr;
+
+    task_graph::task_id task_graph::add(
+      std::string name,
+      std::function<void()> work,
+      std::list<task_id> dependencies)
+    {
+      task_id id = tasks_.size();
+
+      for (task_id dependency : dependencies)
+      {
+        if (dependency >= id)
+        {
+          throw std::invalid_argument(
+            "Task " + name + " depends on a task that does not exist yet");
+        }
+
+        tasks_[dependency].dependents.push_back(id);
+      }
+
+      task t;
+      t.name = std::move(name);
+      t.work = std::move(work);
+      t.remaining = dependencies.size();
+
+      tasks_.push_back(std::move(t));
+
+      return id;
+    }
+
+    void task_graph::write(std::function<void()> op)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        writes_.push_back({std::move(op), current_});
+      }
+
+      changed_.notify_all();
+    }
+
+    void task_graph::parallelFor(
+      size_t count,
+      std::function<void(size_t)> body)
+    {
+      job j;
+      j.body = std::move(body);
+      j.count = count;
+
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      jobs_.push_back(&j);
+      changed_.notify_all();
+
+      while (j.next < j.count)
+      {
+        runIndex(j, lock, false);
+      }
+
+      changed_.wait(lock, [&] () {
+        return (j.running == 0);
+      });
+
+      jobs_.remove(&j);
+
+      // The time the workers spent helping counts towards the calling task.
+      if (current_ != nullptr)
+      {
+        current_->cpuTime += j.helperCpuTime;
+      }
+
+      if (j.error)
+      {
+        std::rethrow_exception(j.error);
+      }
+    }
+
+    void task_graph::runIndex(
+      job& j,
+      std::unique_lock<std::mutex>& lock,
+      bool helping)
+    {
+      size_t index = j.next++;
+      j.running++;
+
+      lock.unlock();
+
+      std::exception_ptr failure;
+      double cpuStart = threadCpuTime();
+
+      try
+      {
+        j.body(index);
+      } catch (...)
+      {
+        failure = std::current_exception();
+      }
+
+      double cpuTime = threadCpuTime() - cpuStart;
+
+      lock.lock();
+
+      if (helping)
+      {
+        j.helperCpuTime += cpuTime;
+      }
+
+      if (failure && !j.error)
+      {
+        j.error = failure;
+
+        // Stops the remaining indices from being started.
+        j.next = j.count;
+      }
+
+      if (--j.running == 0)
+      {
+        changed_.notify_all();
+      }
+    }
+
+    task_graph::job* task_graph::findJob()
+    {
+      for (job* j : jobs_)
+      {
+        if (j->next < j->count)
+        {
+          return j;
+        }
+      }
+
+      return nullptr;
+    }
+
+    void task_graph::countLines(size_t lines)
+    {
+      if (current_ != nullptr)
+      {
+        current_->lines += lines;
+      }
+    }
+
+    void task_graph::countRow(const std::string& table)
+    {
+      if (rows_ != nullptr)
+      {
+        (*rows_)[table]++;
+      }
+    }
+
+    void task_graph::run(size_t threads)
+    {
+      writerProfile_.name = "writes";
+
+      for (task_id id = 0; id < tasks_.size(); id++)
+      {
+        if (tasks_[id].remaining == 0)
+        {
+          ready_.push_back(id);
+        }
+      }
+
+      std::vector<std::thread> workers;
+      for (size_t i = 0; i < std::max<size_t>(threads, 1); i++)
+      {
+        workers.emplace_back(&task_graph::work, this);
+      }
+
+      try
+      {
+        for (;;)
+        {
+          std::deque<write_op> batch;
+
+          {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            changed_.wait(lock, [&] () {
+              return !writes_.empty()
+                || (finished_ == tasks_.size())
+                || (error_ && (running_ == 0));
+            });
+
+            if (error_)
+            {
+              // Nothing that is left to write will be useful, but the running
+              // tasks still need to stop before the workers can be joined.
+              writes_.clear();
+
+              if (running_ == 0)
+              {
+                break;
+              }
+
+              continue;
+            }
+
+            if (writes_.empty())
+            {
+              break;
+            }
+
+            batch.swap(writes_);
+          }
+
+          auto start = std::chrono::steady_clock::now();
+          double cpuStart = threadCpuTime();
+
+          for (write_op& write : batch)
+          {
+            rows_ = (write.owner != nullptr)
+              ? &writtenRows_[write.owner]
+              : nullptr;
+
+            write.op();
+          }
+
+          rows_ = nullptr;
+
+          std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+          writerProfile_.wallTime += elapsed.count();
+          writerProfile_.cpuTime += threadCpuTime() - cpuStart;
+        }
+      } catch (...)
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+
+          if (!error_)
+          {
+            error_ = std::current_exception();
+          }
+        }
+
+        changed_.notify_all();
+      }
+
+      for (std::thread& worker : workers)
+      {
+        worker.join();
+      }
+
+      rows_ = nullptr;
+
+      for (auto& written : writtenRows_)
+      {
+        for (auto& row : written.second)
+        {
+          written.first->rows[row.first] += row.second;
+        }
+      }
+
+      writerProfile_.peakMemory = peakMemory();
+
+      if (error_)
+      {
+        std::rethrow_exception(error_);
+      }
+    }
+
+    void task_graph::work()
+    {
+      for (;;)
+      {
+        task_id id;
+        std::list<profile>::iterator stats;
+
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+
+          changed_.wait(lock, [&] () {
+            return !ready_.empty()
+              || (findJob() != nullptr)
+              || (finished_ == tasks_.size())
+              || error_;
+          });
+
+          if (error_)
+          {
+            return;
+          }
+
+          // Tasks are started before helping with a parallelFor, since the
+          // task that called it works through its own indices anyway.
+          if (ready_.empty())
+          {
+            job* j = findJob();
+            if (j == nullptr)
+            {
+              return;
+            }
+
+            runIndex(*j, lock, true);
+
+            continue;
+          }
+
+          id = ready_.front();
+          ready_.pop_front();
+          running_++;
+
+          stats = runningProfiles_.emplace(std::end(runningProfiles_));
+        }
+
+        stats->name = tasks_[id].name;
+
+        std::exception_ptr failure;
+        auto start = std::chrono::steady_clock::now();
+        double cpuStart = threadCpuTime();
+
+        current_ = &*stats;
+        rows_ = &stats->rows;
+
+        try
+        {
+          tasks_[id].work();
+        } catch (...)
+        {
+          failure = std::current_exception();
+        }
+
+        current_ = nullptr;
+        rows_ = nullptr;
+
+        std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+
+        stats->wallTime = elapsed.count();
+        stats->cpuTime += threadCpuTime() - cpuStart;
+        stats->peakMemory = peakMemory();
+
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+
+          running_--;
+          finished_++;
+
+          if (failure)
+          {
+            if (!error_)
+            {
+              error_ = failure;
+            }
+          } else {
+            std::cout << "Finished " << tasks_[id].name << "." << std::endl;
+
+            profiles_.splice(std::end(profiles_), runningProfiles_, stats);
+
+            for (task_id dependent : tasks_[id].dependents)
+            {
+              if (--tasks_[dependent].remaining == 0)
+              {
+                ready_.push_back(dependent);
+              }
+            }
+          }
+        }
+
+        changed_.notify_all();
+      }
+    }
+
+  };
+};
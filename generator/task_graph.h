@@ -0,0 +1,150 @@
+#ifndef TASK_GRAPH_H_3C7D91E4
+#define TASK_GRAPH_H_3C7D91E4
+
+#include <string>
+#include <list>
+#include <map>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace verbly {
+  namespace generator {
+
+    /**
+     * Runs a set of tasks on a pool of worker threads, starting each task as
+     * soon as the tasks it depends on have finished. Tasks may not touch the
+     * datafile directly; instead, they submit writes, which the thread that
+     * called run performs one at a time in the order they were submitted.
+     * A write submitted by a task therefore always happens after every write
+     * submitted by the tasks it depends on.
+     */
+    class task_graph {
+    public:
+
+      using task_id = size_t;
+
+      // What a task did, and what it cost. The peak memory is that of the
+      // whole process, measured when the task finished, in kilobytes.
+      struct profile {
+        std::string name;
+        double wallTime = 0.0;
+        double cpuTime = 0.0;
+        size_t lines = 0;
+        std::map<std::string, size_t> rows;
+        long peakMemory = 0;
+      };
+
+      // Building
+
+      // Dependencies must be tasks that have already been added, which keeps
+      // the graph acyclic.
+      task_id add(
+        std::string name,
+        std::function<void()> work,
+        std::list<task_id> dependencies = {});
+
+      // Running
+
+      // Queues an operation for the writer. Safe to call from any task.
+      void write(std::function<void()> op);
+
+      // Returns once every task has finished and every write has been
+      // performed. If a task or a write throws, no further tasks are started,
+      // and the first exception is rethrown once the running tasks finish.
+      void run(size_t threads);
+
+      // Calls body once for each index below count. The calling task works
+      // through the indices along with any workers that are idle, so a task
+      // can split up its work without starting threads of its own. Returns
+      // once every call has finished; if any of them throw, no further calls
+      // are started, and the first exception is rethrown.
+      void parallelFor(size_t count, std::function<void(size_t)> body);
+
+      // Profiling
+
+      // Counts towards the task running on the calling thread. Does nothing
+      // if it is not running a task.
+      static void countLines(size_t lines);
+
+      // As above, except that a row counted by a write counts towards the
+      // task that submitted the write.
+      static void countRow(const std::string& table);
+
+      // The profile of each task, in the order the tasks finished.
+      const std::list<profile>& getProfiles() const
+      {
+        return profiles_;
+      }
+
+      // The time the writer spent performing writes.
+      const profile& getWriterProfile() const
+      {
+        return writerProfile_;
+      }
+
+    private:
+
+      struct task {
+        std::string name;
+        std::function<void()> work;
+        size_t remaining = 0;
+        std::list<task_id> dependents;
+      };
+
+      // The indices of a parallelFor that have not been started yet. Jobs
+      // live on the stack of the task that called parallelFor.
+      struct job {
+        std::function<void(size_t)> body;
+        size_t count = 0;
+        size_t next = 0;
+        size_t running = 0;
+        double helperCpuTime = 0.0;
+        std::exception_ptr error;
+      };
+
+      void work();
+
+      // Runs the next index of a job. Must be called with the lock held, and
+      // returns with it held.
+      void runIndex(job& j, std::unique_lock<std::mutex>& lock, bool helping);
+
+      job* findJob();
+
+      struct write_op {
+        std::function<void()> op;
+        profile* owner;
+      };
+
+      std::vector<task> tasks_;
+
+      std::mutex mutex_;
+      std::condition_variable changed_;
+      std::deque<task_id> ready_;
+      std::deque<write_op> writes_;
+      std::list<job*> jobs_;
+      size_t running_ = 0;
+      size_t finished_ = 0;
+      std::exception_ptr error_;
+
+      // A task's profile is moved from the running list to the finished list
+      // without being copied, so that writes can refer to it after the task
+      // finishes. The rows that writes count are only added to it once every
+      // write has been performed, since the task may still be counting rows
+      // of its own while they run.
+      std::list<profile> runningProfiles_;
+      std::list<profile> profiles_;
+      std::map<profile*, std::map<std::string, size_t>> writtenRows_;
+      profile writerProfile_;
+
+      static thread_local profile* current_;
+      static thread_local std::map<std::string, size_t>* rows_;
+    };
+
+  };
+};
+
+#endif /* end of include guard: TASK_GRAPH_H_3C7D91E4 */
@@ -0,0 +1,303 @@
+#include "verbnet_class.h"
+#include <stdexcept>
+#include <hkutil/string.h>
+
+namespace verbly {
+  namespace generator {
+
+    namespace {
+
+      // Returns false at the end of the document.
+      bool advance(xmlTextReaderPtr reader)
+      {
+        int result = xmlTextReaderRead(reader);
+        if (result == -1)
+        {
+          throw std::logic_error("Malformed VerbNet XML");
+        }
+
+        return (result == 1);
+      }
+
+      bool hasName(xmlTextReaderPtr reader, const char* name)
+      {
+        return !xmlStrcmp(
+          xmlTextReaderConstName(reader),
+          reinterpret_cast<const xmlChar*>(name));
+      }
+
+      // Returns false if the current element does not have the attribute.
+      bool getAttribute(
+        xmlTextReaderPtr reader,
+        const char* name,
+        std::string& value)
+      {
+        xmlChar* key = xmlTextReaderGetAttribute(
+          reader,
+          reinterpret_cast<const xmlChar*>(name));
+
+        if (key == nullptr)
+        {
+          return false;
+        }
+
+        value = reinterpret_cast<const char*>(key);
+        xmlFree(key);
+
+        return true;
+      }
+
+      // Calls visit once for each child element of the current element, with
+      // the reader positioned on the child. Grandchildren that visit does not
+      // read are skipped.
+      template <typename Visitor>
+      void forEachChild(xmlTextReaderPtr reader, Visitor visit)
+      {
+        if (xmlTextReaderIsEmptyElement(reader))
+        {
+          return;
+        }
+
+        int depth = xmlTextReaderDepth(reader);
+
+        while (advance(reader))
+        {
+          int type = xmlTextReaderNodeType(reader);
+          int current = xmlTextReaderDepth(reader);
+
+          if ((type == XML_READER_TYPE_END_ELEMENT) && (current == depth))
+          {
+            return;
+          }
+
+          if ((type == XML_READER_TYPE_ELEMENT) && (current == depth + 1))
+          {
+            visit();
+          }
+        }
+
+        throw std::logic_error("Unexpected end of VerbNet XML");
+      }
+
+      // Reads the type of each SELRESTR or SYNRESTR in a restriction list.
+      void readRestrictions(
+        xmlTextReaderPtr reader,
+        const char* name,
+        std::set<std::string>& restrictions)
+      {
+        forEachChild(reader, [&] () {
+          std::string type;
+
+          if (hasName(reader, name) && getAttribute(reader, "type", type))
+          {
+            restrictions.insert(std::move(type));
+          }
+        });
+      }
+
+    };
+
+    verbnet_class::verbnet_class(const std::string& filename)
+    {
+      xmlTextReaderPtr reader = xmlReaderForFile(filename.c_str(), nullptr, 0);
+      if (reader == nullptr)
+      {
+        throw std::logic_error("Error opening " + filename);
+      }
+
+      try
+      {
+        do
+        {
+          if (!advance(reader))
+          {
+            throw std::logic_error("Bad VerbNet file format: " + filename);
+          }
+        } while (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT);
+
+        if (!hasName(reader, "VNCLASS"))
+        {
+          throw std::logic_error("Bad VerbNet file format: " + filename);
+        }
+
+        readClass(reader);
+      } catch (...)
+      {
+        xmlFreeTextReader(reader);
+
+        throw;
+      }
+
+      xmlFreeTextReader(reader);
+    }
+
+    void verbnet_class::readClass(xmlTextReaderPtr reader)
+    {
+      getAttribute(reader, "ID", id_);
+
+      forEachChild(reader, [&] () {
+        if (hasName(reader, "SUBCLASSES"))
+        {
+          forEachChild(reader, [&] () {
+            if (!hasName(reader, "VNSUBCLASS"))
+            {
+              return;
+            }
+
+            std::string subclassId;
+            getAttribute(reader, "ID", subclassId);
+
+            try
+            {
+              subclasses_.emplace_back();
+              subclasses_.back().readClass(reader);
+            } catch (const std::exception& e)
+            {
+              if (subclassId.empty())
+              {
+                std::throw_with_nested(
+                  std::logic_error("Error parsing IDless subgroup"));
+              } else {
+                std::throw_with_nested(
+                  std::logic_error("Error parsing subgroup " + subclassId));
+              }
+            }
+          });
+        } else if (hasName(reader, "MEMBERS"))
+        {
+          forEachChild(reader, [&] () {
+            if (!hasName(reader, "MEMBER"))
+            {
+              return;
+            }
+
+            member m;
+            getAttribute(reader, "name", m.name);
+
+            std::string wnSenses;
+            if (getAttribute(reader, "wn", wnSenses))
+            {
+              m.senseKeys =
+                hatkirby::split<std::list<std::string>>(wnSenses, " ");
+            }
+
+            members_.push_back(std::move(m));
+          });
+        } else if (hasName(reader, "THEMROLES"))
+        {
+          forEachChild(reader, [&] () {
+            if (!hasName(reader, "THEMROLE"))
+            {
+              return;
+            }
+
+            std::string roleName;
+            getAttribute(reader, "type", roleName);
+
+            std::set<std::string> roleSelrestrs;
+
+            forEachChild(reader, [&] () {
+              if (hasName(reader, "SELRESTRS"))
+              {
+                readRestrictions(reader, "SELRESTR", roleSelrestrs);
+              }
+            });
+
+            roles_.emplace_back(std::move(roleName), std::move(roleSelrestrs));
+          });
+        } else if (hasName(reader, "FRAMES"))
+        {
+          forEachChild(reader, [&] () {
+            if (!hasName(reader, "FRAME"))
+            {
+              return;
+            }
+
+            forEachChild(reader, [&] () {
+              if (!hasName(reader, "SYNTAX"))
+              {
+                return;
+              }
+
+              frame_description fr;
+
+              forEachChild(reader, [&] () {
+                part_description p;
+
+                if (hasName(reader, "NP"))
+                {
+                  p.type = part_type::noun_phrase;
+                  getAttribute(reader, "value", p.value);
+
+                  forEachChild(reader, [&] () {
+                    if (hasName(reader, "SYNRESTRS"))
+                    {
+                      readRestrictions(reader, "SYNRESTR", p.synrestrs);
+                    } else if (hasName(reader, "SELRESTRS"))
+                    {
+                      readRestrictions(reader, "SELRESTR", p.selrestrs);
+                    }
+                  });
+                } else if (hasName(reader, "VERB"))
+                {
+                  p.type = part_type::verb;
+                } else if (hasName(reader, "PREP"))
+                {
+                  p.type = part_type::preposition;
+
+                  std::string choicesStr;
+                  if (getAttribute(reader, "value", choicesStr))
+                  {
+                    p.literal = true;
+
+                    auto choices =
+                      hatkirby::split<std::list<std::string>>(
+                        choicesStr, " ");
+
+                    for (std::string choice : choices)
+                    {
+                      int chloc;
+                      while ((chloc = choice.find_first_of("_"))
+                              != std::string::npos)
+                      {
+                        choice.replace(chloc, 1, " ");
+                      }
+
+                      p.choices.insert(std::move(choice));
+                    }
+                  } else {
+                    p.literal = false;
+
+                    forEachChild(reader, [&] () {
+                      if (hasName(reader, "SELRESTRS"))
+                      {
+                        readRestrictions(reader, "SELRESTR", p.choices);
+                      }
+                    });
+                  }
+                } else if (hasName(reader, "ADJ"))
+                {
+                  p.type = part_type::adjective;
+                } else if (hasName(reader, "ADV"))
+                {
+                  p.type = part_type::adverb;
+                } else if (hasName(reader, "LEX"))
+                {
+                  p.type = part_type::literal;
+                  getAttribute(reader, "value", p.value);
+                } else {
+                  return;
+                }
+
+                fr.push_back(std::move(p));
+              });
+
+              frames_.push_back(std::move(fr));
+            });
+          });
+        }
+      });
+    }
+
+  };
+};
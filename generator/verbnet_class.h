@@ -0,0 +1,93 @@
+#ifndef VERBNET_CLASS_H_8A1F5C62
+#define VERBNET_CLASS_H_8A1F5C62
+
+#include <string>
+#include <list>
+#include <set>
+#include <libxml/xmlreader.h>
+#include "role.h"
+#include "../lib/enums.h"
+
+namespace verbly {
+  namespace generator {
+
+    /**
+     * The contents of a VerbNet class file, or of one of its subclasses. The
+     * file is read with libxml's streaming reader, so no DOM is built, and
+     * nothing that is assigned an ID is created, so that files can be read
+     * concurrently and turned into groups afterwards in a fixed order.
+     */
+    class verbnet_class {
+    public:
+
+      struct member {
+        std::string name;
+
+        // The WordNet sense keys listed for the member, without the trailing
+        // "::" that the WordNet sense key table uses.
+        std::list<std::string> senseKeys;
+      };
+
+      // The description of a part of a frame, from which a part can be
+      // created. For a noun phrase, value is the role; for a literal, it is
+      // the literal. For a preposition, choices holds the literal choices or
+      // the selectional restrictions.
+      struct part_description {
+        part_type type;
+        std::string value;
+        std::set<std::string> selrestrs;
+        std::set<std::string> synrestrs;
+        std::set<std::string> choices;
+        bool literal = false;
+      };
+
+      using frame_description = std::list<part_description>;
+
+      // Constructors
+
+      verbnet_class() = default;
+
+      explicit verbnet_class(const std::string& filename);
+
+      // Accessors
+
+      const std::string& getId() const
+      {
+        return id_;
+      }
+
+      const std::list<member>& getMembers() const
+      {
+        return members_;
+      }
+
+      const std::list<role>& getRoles() const
+      {
+        return roles_;
+      }
+
+      const std::list<frame_description>& getFrames() const
+      {
+        return frames_;
+      }
+
+      const std::list<verbnet_class>& getSubclasses() const
+      {
+        return subclasses_;
+      }
+
+    private:
+
+      void readClass(xmlTextReaderPtr reader);
+
+      std::string id_;
+      std::list<member> members_;
+      std::list<role> roles_;
+      std::list<frame_description> frames_;
+      std::list<verbnet_class> subclasses_;
+    };
+
+  };
+};
+
+#endif /* end of include guard: VERBNET_CLASS_H_8A1F5C62 */
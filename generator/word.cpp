@@ -4,6 +4,7 @@
 #include "notion.h"
 #include "lemma.h"
 #include "group.h"
+#include "task_graph.h"
 
 namespace verbly {
   namespace generator {
@@ -67,6 +68,8 @@ namespace verbly {
         fields.emplace_back("group_id", arg.getVerbGroup().getId());
       }
 
+      task_graph::countRow("words");
+
       db.insertIntoTable("words", std::move(fields));
 
       return db;
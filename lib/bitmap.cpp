@@ -0,0 +1,379 @@
+#include "bitmap.h"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace verbly {
+
+  namespace {
+
+    size_t popcount(uint64_t word)
+    {
+      return __builtin_popcountll(word);
+    }
+
+  };
+
+  bool bitmap::container::contains(uint16_t value) const
+  {
+    if (isBitset())
+    {
+      return (words[value / 64] >> (value % 64)) & 1;
+    } else {
+      return std::binary_search(std::begin(array), std::end(array), value);
+    }
+  }
+
+  void bitmap::container::add(uint16_t value)
+  {
+    if (isBitset())
+    {
+      uint64_t& word = words[value / 64];
+      uint64_t bit = uint64_t(1) << (value % 64);
+
+      if (!(word & bit))
+      {
+        word |= bit;
+        cardinality++;
+      }
+    } else {
+      // Values are usually added in increasing order, so check the end first.
+      if (array.empty() || (array.back() < value))
+      {
+        array.push_back(value);
+      } else {
+        auto it = std::lower_bound(std::begin(array), std::end(array), value);
+
+        if (*it == value)
+        {
+          return;
+        }
+
+        array.insert(it, value);
+      }
+
+      cardinality++;
+
+      if (cardinality > maxArraySize)
+      {
+        toBitset();
+      }
+    }
+  }
+
+  void bitmap::container::toBitset()
+  {
+    words.assign(bitsetWords, 0);
+
+    for (uint16_t value : array)
+    {
+      words[value / 64] |= uint64_t(1) << (value % 64);
+    }
+
+    array.clear();
+    array.shrink_to_fit();
+  }
+
+  void bitmap::container::toArray()
+  {
+    array.clear();
+    array.reserve(cardinality);
+
+    for (size_t i = 0; i < bitsetWords; i++)
+    {
+      uint64_t word = words[i];
+
+      while (word)
+      {
+        array.push_back(static_cast<uint16_t>((i * 64) + __builtin_ctzll(word)));
+        word &= word - 1;
+      }
+    }
+
+    words.clear();
+    words.shrink_to_fit();
+  }
+
+  void bitmap::add(uint32_t value)
+  {
+    uint16_t key = static_cast<uint16_t>(value >> 16);
+    uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+
+    if (containers_.empty() || (containers_.back().key < key))
+    {
+      containers_.emplace_back();
+      containers_.back().key = key;
+      containers_.back().add(low);
+
+      return;
+    }
+
+    auto it =
+      std::lower_bound(
+        std::begin(containers_),
+        std::end(containers_),
+        key,
+        [] (const container& c, uint16_t k) {
+          return c.key < k;
+        });
+
+    if (it->key != key)
+    {
+      it = containers_.emplace(it);
+      it->key = key;
+    }
+
+    it->add(low);
+  }
+
+  size_t bitmap::size() const
+  {
+    size_t result = 0;
+
+    for (const container& c : containers_)
+    {
+      result += c.cardinality;
+    }
+
+    return result;
+  }
+
+  bool bitmap::contains(uint32_t value) const
+  {
+    uint16_t key = static_cast<uint16_t>(value >> 16);
+
+    auto it =
+      std::lower_bound(
+        std::begin(containers_),
+        std::end(containers_),
+        key,
+        [] (const container& c, uint16_t k) {
+          return c.key < k;
+        });
+
+    return (it != std::end(containers_))
+      && (it->key == key)
+      && it->contains(static_cast<uint16_t>(value & 0xFFFF));
+  }
+
+  uint32_t bitmap::select(size_t rank) const
+  {
+    for (const container& c : containers_)
+    {
+      if (rank >= c.cardinality)
+      {
+        rank -= c.cardinality;
+
+        continue;
+      }
+
+      uint32_t high = static_cast<uint32_t>(c.key) << 16;
+
+      if (!c.isBitset())
+      {
+        return high | c.array[rank];
+      }
+
+      for (size_t i = 0; i < bitsetWords; i++)
+      {
+        uint64_t word = c.words[i];
+        size_t count = popcount(word);
+
+        if (rank >= count)
+        {
+          rank -= count;
+
+          continue;
+        }
+
+        for (; rank > 0; rank--)
+        {
+          word &= word - 1;
+        }
+
+        return high | static_cast<uint32_t>((i * 64) + __builtin_ctzll(word));
+      }
+    }
+
+    throw std::out_of_range("Rank is larger than the bitmap");
+  }
+
+  bitmap::container bitmap::intersect(
+    const container& left,
+    const container& right)
+  {
+    container result;
+    result.key = left.key;
+
+    if (left.isBitset() && right.isBitset())
+    {
+      result.words.resize(bitsetWords);
+
+      for (size_t i = 0; i < bitsetWords; i++)
+      {
+        result.words[i] = left.words[i] & right.words[i];
+      }
+
+      for (size_t i = 0; i < bitsetWords; i++)
+      {
+        result.cardinality += popcount(result.words[i]);
+      }
+
+      if (result.cardinality <= maxArraySize)
+      {
+        result.toArray();
+      }
+    } else if (left.isBitset() || right.isBitset())
+    {
+      const container& sparse = left.isBitset() ? right : left;
+      const container& dense = left.isBitset() ? left : right;
+
+      for (uint16_t value : sparse.array)
+      {
+        if (dense.contains(value))
+        {
+          result.array.push_back(value);
+        }
+      }
+
+      result.cardinality = result.array.size();
+    } else {
+      std::set_intersection(
+        std::begin(left.array),
+        std::end(left.array),
+        std::begin(right.array),
+        std::end(right.array),
+        std::back_inserter(result.array));
+
+      result.cardinality = result.array.size();
+    }
+
+    return result;
+  }
+
+  bitmap::container bitmap::unite(
+    const container& left,
+    const container& right)
+  {
+    if (left.isBitset() && right.isBitset())
+    {
+      container result;
+      result.key = left.key;
+      result.words.resize(bitsetWords);
+
+      for (size_t i = 0; i < bitsetWords; i++)
+      {
+        result.words[i] = left.words[i] | right.words[i];
+      }
+
+      for (size_t i = 0; i < bitsetWords; i++)
+      {
+        result.cardinality += popcount(result.words[i]);
+      }
+
+      return result;
+    } else if (left.isBitset() || right.isBitset())
+    {
+      const container& sparse = left.isBitset() ? right : left;
+      container result = left.isBitset() ? left : right;
+
+      for (uint16_t value : sparse.array)
+      {
+        result.add(value);
+      }
+
+      return result;
+    } else {
+      container result;
+      result.key = left.key;
+
+      std::set_union(
+        std::begin(left.array),
+        std::end(left.array),
+        std::begin(right.array),
+        std::end(right.array),
+        std::back_inserter(result.array));
+
+      result.cardinality = result.array.size();
+
+      if (result.cardinality > maxArraySize)
+      {
+        result.toBitset();
+      }
+
+      return result;
+    }
+  }
+
+  bitmap bitmap::operator&(const bitmap& other) const
+  {
+    bitmap result;
+
+    auto left = std::begin(containers_);
+    auto right = std::begin(other.containers_);
+
+    while ((left != std::end(containers_))
+      && (right != std::end(other.containers_)))
+    {
+      if (left->key < right->key)
+      {
+        left++;
+      } else if (right->key < left->key)
+      {
+        right++;
+      } else {
+        container c = intersect(*left, *right);
+
+        if (c.cardinality > 0)
+        {
+          result.containers_.push_back(std::move(c));
+        }
+
+        left++;
+        right++;
+      }
+    }
+
+    return result;
+  }
+
+  bitmap bitmap::operator|(const bitmap& other) const
+  {
+    bitmap result;
+
+    auto left = std::begin(containers_);
+    auto right = std::begin(other.containers_);
+
+    while ((left != std::end(containers_))
+      || (right != std::end(other.containers_)))
+    {
+      if ((right == std::end(other.containers_))
+        || ((left != std::end(containers_)) && (left->key < right->key)))
+      {
+        result.containers_.push_back(*left);
+        left++;
+      } else if ((left == std::end(containers_)) || (right->key < left->key))
+      {
+        result.containers_.push_back(*right);
+        right++;
+      } else {
+        result.containers_.push_back(unite(*left, *right));
+        left++;
+        right++;
+      }
+    }
+
+    return result;
+  }
+
+  bitmap& bitmap::operator&=(const bitmap& other)
+  {
+    return (*this = (*this & other));
+  }
+
+  bitmap& bitmap::operator|=(const bitmap& other)
+  {
+    return (*this = (*this | other));
+  }
+
+};
@@ -0,0 +1,88 @@
+#ifndef BITMAP_H_2F7C9B14
+#define BITMAP_H_2F7C9B14
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace verbly {
+
+  /**
+   * A compressed set of 32-bit integers in the style of a Roaring bitmap. The
+   * values are partitioned by their high 16 bits into containers, each of which
+   * holds its low 16 bits either as a sorted array (when sparse) or as a
+   * fixed-size bitset (when dense). Set operations between two bitset
+   * containers are plain loops over 64-bit words, which the compiler is free
+   * to vectorize.
+   */
+  class bitmap {
+  public:
+
+    // Modification
+
+    void add(uint32_t value);
+
+    // Accessors
+
+    bool empty() const
+    {
+      return containers_.empty();
+    }
+
+    size_t size() const;
+
+    bool contains(uint32_t value) const;
+
+    // Returns the value with the given rank, i.e. the (rank+1)th smallest
+    // value in the set.
+    uint32_t select(size_t rank) const;
+
+    // Set algebra
+
+    bitmap operator&(const bitmap& other) const;
+    bitmap operator|(const bitmap& other) const;
+
+    bitmap& operator&=(const bitmap& other);
+    bitmap& operator|=(const bitmap& other);
+
+  private:
+
+    // Containers with more values than this are stored as bitsets.
+    static const size_t maxArraySize = 4096;
+
+    static const size_t bitsetWords = 65536 / 64;
+
+    struct container {
+      uint16_t key;
+      size_t cardinality = 0;
+
+      // Exactly one of these is used. If words is empty, this is an array
+      // container.
+      std::vector<uint16_t> array;
+      std::vector<uint64_t> words;
+
+      bool isBitset() const
+      {
+        return !words.empty();
+      }
+
+      bool contains(uint16_t value) const;
+
+      void add(uint16_t value);
+
+      void toBitset();
+
+      void toArray();
+    };
+
+    static container intersect(const container& left, const container& right);
+
+    static container unite(const container& left, const container& right);
+
+    std::vector<container> containers_;
+
+  };
+
+};
+
+#endif /* end of include guard: BITMAP_H_2F7C9B14 */
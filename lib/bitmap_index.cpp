@@ -0,0 +1,265 @@
+#include "bitmap_index.h"
+#include <set>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include "statement.h"
+#include "order.h"
+#include "notion.h"
+#include "word.h"
+#include "form.h"
+#include "pronunciation.h"
+
+namespace verbly {
+
+  namespace {
+
+    /**
+     * A sample is selected with one OR term and one bound parameter per ID.
+     * SQLite limits the depth of an expression tree to 1000 and, in older
+     * versions, the number of parameters to 999, so larger samples are left to
+     * the SQL query.
+     */
+    const size_t maxSampleSize = 500;
+
+    const field& getIdForContext(object context)
+    {
+      switch (context)
+      {
+        case object::notion: return notion::id;
+        case object::word: return word::id;
+        case object::form: return form::id;
+        case object::pronunciation: return pronunciation::id;
+
+        case object::undefined:
+        case object::frame:
+        case object::part:
+        {
+          throw std::domain_error("Provided context is not indexed");
+        }
+      }
+
+      throw std::domain_error("Invalid context");
+    }
+
+    std::vector<int> getDistinctValues(
+      hatkirby::database& db,
+      std::string table,
+      std::string column)
+    {
+      std::vector<hatkirby::row> rows =
+        db.queryAll(
+          "SELECT DISTINCT " + column + " FROM " + table
+            + " WHERE " + column + " IS NOT NULL");
+
+      std::vector<int> result;
+
+      for (hatkirby::row& r : rows)
+      {
+        result.push_back(std::get<int>(r[0]));
+      }
+
+      return result;
+    }
+
+  };
+
+  bitmap_index::bitmap_index(hatkirby::database& db)
+  {
+    // Every word belongs to exactly one notion, so the notion attributes are
+    // also indexed by word.
+    for (int value : getDistinctValues(db, "notions", "part_of_speech"))
+    {
+      addAttribute(db, object::notion, notion::partOfSpeech == value);
+      addAttribute(db, object::word, notion::partOfSpeech == value);
+    }
+
+    addAttribute(db, object::notion, notion::numOfImages >= 1);
+    addAttribute(db, object::word, notion::numOfImages >= 1);
+
+    for (int value : getDistinctValues(db, "words", "position"))
+    {
+      addAttribute(db, object::word, word::adjectivePosition == value);
+    }
+
+    for (int value : getDistinctValues(db, "forms", "complexity"))
+    {
+      addAttribute(db, object::form, form::complexity == value);
+    }
+
+    addAttribute(db, object::form, form::proper == true);
+    addAttribute(db, object::form, form::proper == false);
+
+    for (int value : getDistinctValues(db, "pronunciations", "syllables"))
+    {
+      addAttribute(
+        db,
+        object::pronunciation,
+        pronunciation::numOfSyllables == value);
+    }
+  }
+
+  void bitmap_index::addAttribute(
+    hatkirby::database& db,
+    object context,
+    filter attribute)
+  {
+    const field& id = getIdForContext(context);
+
+    // Use the regular statement compiler to find the matching objects, which
+    // also takes care of joining against other tables when needed.
+    statement stmt(context, attribute);
+
+    std::vector<hatkirby::row> rows =
+      db.queryAll(
+        stmt.getQueryString({ id.getColumn() }, order(id), 0),
+        stmt.getBindings());
+
+    bitmap& ids = attributes_[context][std::move(attribute)];
+
+    for (hatkirby::row& r : rows)
+    {
+      ids.add(static_cast<uint32_t>(std::get<int>(r[0])));
+    }
+  }
+
+  std::optional<filter> bitmap_index::sample(
+    object context,
+    filter queryFilter,
+    int limit) const
+  {
+    if ((limit <= 0) || !attributes_.count(context))
+    {
+      return {};
+    }
+
+    bitmap matches;
+    if (!evaluate(
+      context,
+      queryFilter.compact().normalize(context),
+      matches))
+    {
+      return {};
+    }
+
+    const field& id = getIdForContext(context);
+    size_t count = matches.size();
+
+    if (count == 0)
+    {
+      // Object IDs are never negative, so this matches nothing.
+      return filter(id, filter::comparison::int_is_less_than, 0);
+    }
+
+    // Choose the ranks to sample using Floyd's algorithm, which picks a
+    // uniformly random subset in as many steps as the size of the subset.
+    static thread_local std::mt19937 rng(std::random_device{}());
+
+    size_t sampleSize = std::min(static_cast<size_t>(limit), count);
+    if (sampleSize > maxSampleSize)
+    {
+      return {};
+    }
+
+    std::set<size_t> ranks;
+
+    for (size_t j = count - sampleSize; j < count; j++)
+    {
+      std::uniform_int_distribution<size_t> dist(0, j);
+
+      if (!ranks.insert(dist(rng)).second)
+      {
+        ranks.insert(j);
+      }
+    }
+
+    filter result(true);
+
+    for (size_t rank : ranks)
+    {
+      result += (id == static_cast<int>(matches.select(rank)));
+    }
+
+    return result;
+  }
+
+  /**
+   * This method computes the set of objects matching a normalized filter, if
+   * the filter only consists of indexed attributes combined using AND and OR.
+   * It returns false if any part of the filter is not indexed.
+   */
+  bool bitmap_index::evaluate(
+    object context,
+    const filter& clause,
+    bitmap& result) const
+  {
+    switch (clause.getType())
+    {
+      case filter::type::empty:
+      {
+        return false;
+      }
+
+      case filter::type::singleton:
+      {
+        if ((context == object::word)
+          && (clause.getComparison() == filter::comparison::matches)
+          && (clause.getField().getType() == field::type::join)
+          && (clause.getField().getJoinObject() == object::notion))
+        {
+          return evaluate(context, clause.getJoinCondition(), result);
+        }
+
+        const std::unordered_map<filter, bitmap>& attributes =
+          attributes_.at(context);
+
+        auto it = attributes.find(clause);
+
+        if (it == std::end(attributes))
+        {
+          return false;
+        }
+
+        result = it->second;
+
+        return true;
+      }
+
+      case filter::type::group:
+      {
+        bool first = true;
+
+        for (const filter& child : clause)
+        {
+          bitmap childResult;
+
+          if (!evaluate(context, child, childResult))
+          {
+            return false;
+          }
+
+          if (first)
+          {
+            result = std::move(childResult);
+            first = false;
+          } else if (clause.getOrlogic())
+          {
+            result |= childResult;
+          } else {
+            result &= childResult;
+          }
+        }
+
+        return !first;
+      }
+
+      case filter::type::mask:
+      {
+        return evaluate(context, clause.getMaskFilter(), result);
+      }
+    }
+
+    throw std::domain_error("Invalid filter type");
+  }
+
+};
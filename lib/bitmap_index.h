@@ -0,0 +1,67 @@
+#ifndef BITMAP_INDEX_H_8D3E61A0
+#define BITMAP_INDEX_H_8D3E61A0
+
+#include <map>
+#include <unordered_map>
+#include <optional>
+#include <hkutil/database.h>
+#include "enums.h"
+#include "filter.h"
+#include "bitmap.h"
+
+namespace verbly {
+
+  /**
+   * An in-memory index of the objects that satisfy each of a fixed set of
+   * conditions on low-cardinality attributes, such as a notion's part of
+   * speech or a form's complexity. A query whose filter can be expressed as a
+   * combination of these conditions can then be answered by set algebra on
+   * bitmaps of object IDs instead of by scanning tables.
+   */
+  class bitmap_index {
+  public:
+
+    // Constructors
+
+    bitmap_index() = default;
+
+    explicit bitmap_index(hatkirby::database& db);
+
+    // Accessors
+
+    bool empty() const
+    {
+      return attributes_.empty();
+    }
+
+    /**
+     * If the filter can be evaluated entirely using the index, this returns a
+     * filter that selects a uniformly random sample of at most the given
+     * number of the objects that the filter matches, by ID. Otherwise, or if
+     * the sample would be too large to select by ID, it returns nothing and
+     * the filter must be compiled into SQL as usual.
+     */
+    std::optional<filter> sample(
+      object context,
+      filter queryFilter,
+      int limit) const;
+
+  private:
+
+    bool evaluate(
+      object context,
+      const filter& clause,
+      bitmap& result) const;
+
+    void addAttribute(
+      hatkirby::database& db,
+      object context,
+      filter attribute);
+
+    std::map<object, std::unordered_map<filter, bitmap>> attributes_;
+
+  };
+
+};
+
+#endif /* end of include guard: BITMAP_INDEX_H_8D3E61A0 */
@@ -0,0 +1,144 @@
+#include "connection.h"
+#include <type_traits>
+
+namespace verbly {
+
+  cursor::cursor(
+    sqlite3* ppdb,
+    const std::string& queryString,
+    const std::list<hatkirby::binding>& bindings) :
+      ppdb_(ppdb)
+  {
+    sqlite3_stmt* tempstmt;
+
+    if (sqlite3_prepare_v2(
+      ppdb_,
+      queryString.c_str(),
+      queryString.length(),
+      &tempstmt,
+      NULL) != SQLITE_OK)
+    {
+      throw database_error(
+        "Error preparing query",
+        sqlite3_errmsg(ppdb_));
+    }
+
+    ppstmt_.reset(tempstmt);
+
+    int i = 1;
+    for (const hatkirby::binding& value : bindings)
+    {
+      int result =
+        std::visit(
+          [&] (const auto& arg) {
+            using T = std::decay_t<decltype(arg)>;
+
+            if constexpr (std::is_same_v<T, int>)
+            {
+              return sqlite3_bind_int(ppstmt_.get(), i, arg);
+            } else if constexpr (std::is_same_v<T, std::string>)
+            {
+              return sqlite3_bind_text(
+                ppstmt_.get(),
+                i,
+                arg.c_str(),
+                arg.length(),
+                SQLITE_TRANSIENT);
+            } else if constexpr (std::is_same_v<T, double>)
+            {
+              return sqlite3_bind_double(ppstmt_.get(), i, arg);
+            } else if constexpr (std::is_same_v<T, std::nullptr_t>)
+            {
+              return sqlite3_bind_null(ppstmt_.get(), i);
+            } else {
+              return sqlite3_bind_blob(
+                ppstmt_.get(),
+                i,
+                arg.data(),
+                arg.size(),
+                SQLITE_TRANSIENT);
+            }
+          },
+          value);
+
+      if (result != SQLITE_OK)
+      {
+        throw database_error(
+          "Error binding value to query",
+          sqlite3_errmsg(ppdb_));
+      }
+
+      i++;
+    }
+  }
+
+  bool cursor::next()
+  {
+    int result = sqlite3_step(ppstmt_.get());
+
+    if (result == SQLITE_ROW)
+    {
+      return true;
+    } else if (result == SQLITE_DONE)
+    {
+      return false;
+    } else {
+      throw database_error(
+        "Error reading from query",
+        sqlite3_errmsg(ppdb_));
+    }
+  }
+
+  std::string cursor::getString(int column) const
+  {
+    // The text must be requested before its length, so that the length is of
+    // the UTF-8 representation.
+    const unsigned char* text = sqlite3_column_text(ppstmt_.get(), column);
+    int length = sqlite3_column_bytes(ppstmt_.get(), column);
+
+    if (!text)
+    {
+      return {};
+    }
+
+    return std::string(reinterpret_cast<const char*>(text), length);
+  }
+
+  hatkirby::blob_type cursor::getBlob(int column) const
+  {
+    const unsigned char* data =
+      static_cast<const unsigned char*>(
+        sqlite3_column_blob(ppstmt_.get(), column));
+
+    int length = sqlite3_column_bytes(ppstmt_.get(), column);
+
+    if (!data)
+    {
+      return {};
+    }
+
+    return hatkirby::blob_type(data, data + length);
+  }
+
+  connection::connection(const std::string& path)
+  {
+    sqlite3* tempdb;
+
+    int result =
+      sqlite3_open_v2(
+        path.c_str(),
+        &tempdb,
+        SQLITE_OPEN_READONLY | SQLITE_OPEN_FULLMUTEX,
+        NULL);
+
+    ppdb_.reset(tempdb);
+
+    if (result != SQLITE_OK)
+    {
+      throw database_error(
+        "Could not open verbly datafile",
+        sqlite3_errmsg(tempdb));
+    }
+  }
+
+};
@@ -0,0 +1,107 @@
+#ifndef CONNECTION_H_E34D0E66
+#define CONNECTION_H_E34D0E66
+
+#include <string>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <sqlite3.h>
+#include <hkutil/database.h>
+
+namespace verbly {
+
+  class database_error : public std::logic_error {
+  public:
+
+    database_error(
+      std::string msg,
+      std::string sqlMsg) :
+        std::logic_error(msg + " (" + sqlMsg + ")")
+    {
+    }
+  };
+
+  /**
+   * A prepared query over which results can be read one row at a time. The
+   * columns of the current row are read directly from SQLite, so objects can
+   * be constructed from them without first copying the row into a
+   * hatkirby::row. Column indices start at zero.
+   */
+  class cursor {
+  public:
+
+    cursor(
+      sqlite3* ppdb,
+      const std::string& queryString,
+      const std::list<hatkirby::binding>& bindings);
+
+    // Advances to the next row, returning false once there are no more rows.
+    bool next();
+
+    bool isNull(int column) const
+    {
+      return (sqlite3_column_type(ppstmt_.get(), column) == SQLITE_NULL);
+    }
+
+    int getInteger(int column) const
+    {
+      return sqlite3_column_int(ppstmt_.get(), column);
+    }
+
+    bool getBoolean(int column) const
+    {
+      return (sqlite3_column_int(ppstmt_.get(), column) == 1);
+    }
+
+    std::string getString(int column) const;
+
+    hatkirby::blob_type getBlob(int column) const;
+
+  private:
+
+    class stmt_deleter {
+    public:
+
+      void operator()(sqlite3_stmt* ptr) const
+      {
+        sqlite3_finalize(ptr);
+      }
+    };
+
+    sqlite3* ppdb_;
+    std::unique_ptr<sqlite3_stmt, stmt_deleter> ppstmt_;
+  };
+
+  /**
+   * A read-only connection to the datafile that queries for objects are run
+   * on.
+   */
+  class connection {
+  public:
+
+    explicit connection(const std::string& path);
+
+    cursor query(
+      const std::string& queryString,
+      const std::list<hatkirby::binding>& bindings = {}) const
+    {
+      return cursor(ppdb_.get(), queryString, bindings);
+    }
+
+  private:
+
+    class sqlite3_deleter {
+    public:
+
+      void operator()(sqlite3* ptr) const
+      {
+        sqlite3_close_v2(ptr);
+      }
+    };
+
+    std::unique_ptr<sqlite3, sqlite3_deleter> ppdb_;
+  };
+
+};
+
+#endif /* end of include guard: CONNECTION_H_E34D0E66 */
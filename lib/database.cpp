@@ -1,13 +1,17 @@
 #include "database.h"
 #include <sstream>
+#include <iterator>
+#include <hkutil/string.h>
 #include "query.h"
 #include "version.h"
 
 namespace verbly {
 
   database::database(
-    std::string path) :
-      ppdb_(std::move(path), hatkirby::dbmode::read)
+    std::string path,
+    bool bitmapIndex) :
+      ppdb_(path, hatkirby::dbmode::read),
+      conn_(path)
   {
     hatkirby::row version =
       ppdb_.queryFirst("SELECT major, minor FROM version");
@@ -19,67 +23,267 @@ namespace verbly {
     {
       throw database_version_mismatch(DATABASE_MAJOR_VERSION, major_);
     }
+
+    stats_ = statistics(ppdb_);
+
+    for (hatkirby::row& r : ppdb_.queryAll("SELECT bit, name FROM selrestr_names"))
+    {
+      selrestrBits_[std::get<std::string>(r[1])] = std::get<int>(r[0]);
+    }
+
+    for (hatkirby::row& r : ppdb_.queryAll("SELECT bit, name FROM synrestr_names"))
+    {
+      synrestrBits_[std::get<std::string>(r[1])] = std::get<int>(r[0]);
+    }
+
+    if (bitmapIndex)
+    {
+      index_ = bitmap_index(ppdb_);
+    }
   }
 
   query<notion> database::notions(filter where, order sortOrder, int limit) const
   {
-    return query<notion>(*this, ppdb_, std::move(where), std::move(sortOrder), limit);
+    return query<notion>(*this, conn_, std::move(where), std::move(sortOrder), limit, getPlanningStatistics(), &index_);
   }
 
   query<word> database::words(filter where, order sortOrder, int limit) const
   {
-    return query<word>(*this, ppdb_, std::move(where), std::move(sortOrder), limit);
+    return query<word>(*this, conn_, std::move(where), std::move(sortOrder), limit, getPlanningStatistics(), &index_);
   }
 
   query<frame> database::frames(filter where, order sortOrder, int limit) const
   {
-    return query<frame>(*this, ppdb_, std::move(where), std::move(sortOrder), limit);
+    return query<frame>(*this, conn_, std::move(where), std::move(sortOrder), limit, getPlanningStatistics(), &index_);
   }
 
   query<part> database::parts(filter where, order sortOrder, int limit) const
   {
-    return query<part>(*this, ppdb_, std::move(where), std::move(sortOrder), limit);
+    return query<part>(*this, conn_, std::move(where), std::move(sortOrder), limit, getPlanningStatistics(), &index_);
   }
 
   query<form> database::forms(filter where, order sortOrder, int limit) const
   {
-    return query<form>(*this, ppdb_, std::move(where), std::move(sortOrder), limit);
+    return query<form>(*this, conn_, std::move(where), std::move(sortOrder), limit, getPlanningStatistics(), &index_);
   }
 
   query<pronunciation> database::pronunciations(filter where, order sortOrder, int limit) const
   {
-    return query<pronunciation>(*this, ppdb_, std::move(where), std::move(sortOrder), limit);
+    return query<pronunciation>(*this, conn_, std::move(where), std::move(sortOrder), limit, getPlanningStatistics(), &index_);
   }
 
-  std::set<std::string> database::selrestrs(int partId) const
+  std::map<std::tuple<int, inflection>, std::vector<form>>
+    database::getLemmaForms(
+      const std::set<int>& lemmaIds,
+      const std::set<inflection>& categories) const
   {
-    std::vector<hatkirby::row> rows =
-      ppdb_.queryAll(
-        "SELECT selrestr FROM selrestrs WHERE part_id = ?",
-        { partId });
+    std::map<std::tuple<int, inflection>, std::vector<form>> result;
 
-    std::set<std::string> result;
+    std::list<std::string> formColumns;
+    for (const std::string& column : form::select)
+    {
+      formColumns.push_back("forms." + column);
+    }
+
+    std::list<std::string> categoryPlaceholders;
+    std::list<hatkirby::binding> categoryBindings;
+    for (inflection category : categories)
+    {
+      categoryPlaceholders.push_back("?");
+      categoryBindings.push_back(static_cast<int>(category));
+    }
+
+    // Stay well below SQLite's limit on the number of bound parameters.
+    const size_t batchSize = 500;
+
+    auto it = std::begin(lemmaIds);
+    while (it != std::end(lemmaIds))
+    {
+      std::list<std::string> lemmaPlaceholders;
+      std::list<hatkirby::binding> bindings;
+
+      for (size_t i = 0; (i < batchSize) && (it != std::end(lemmaIds)); i++, it++)
+      {
+        lemmaPlaceholders.push_back("?");
+        bindings.push_back(*it);
+      }
+
+      for (const hatkirby::binding& b : categoryBindings)
+      {
+        bindings.push_back(b);
+      }
+
+      std::ostringstream queryStream;
+      queryStream << "SELECT DISTINCT ";
+      queryStream << hatkirby::implode(std::begin(formColumns), std::end(formColumns), ", ");
+      queryStream << ", lemmas_forms.lemma_id, lemmas_forms.category FROM lemmas_forms INNER JOIN forms";
+      queryStream << " ON forms.form_id = lemmas_forms.form_id";
+      queryStream << " WHERE lemmas_forms.lemma_id IN (";
+      queryStream << hatkirby::implode(std::begin(lemmaPlaceholders), std::end(lemmaPlaceholders), ", ");
+      queryStream << ") AND lemmas_forms.category IN (";
+      queryStream << hatkirby::implode(std::begin(categoryPlaceholders), std::end(categoryPlaceholders), ", ");
+      queryStream << ") ORDER BY forms.form_id";
+
+      // The form columns come first so that the forms can be read straight
+      // from the cursor.
+      cursor rows = conn_.query(queryStream.str(), bindings);
+      int lemmaColumn = formColumns.size();
+
+      while (rows.next())
+      {
+        auto key =
+          std::make_tuple(
+            rows.getInteger(lemmaColumn),
+            static_cast<inflection>(rows.getInteger(lemmaColumn + 1)));
+
+        result[key].emplace_back(*this, rows);
+      }
+    }
+
+    return result;
+  }
+
+  std::shared_ptr<const std::vector<frame>> database::getGroupFrames(
+    int groupId) const
+  {
+    frame_catalog& catalog = *frameCatalog_;
+
+    std::call_once(catalog.loaded, [&] () {
+      std::map<int, std::vector<frame>> groups;
+
+      for (frame& f : frames({}, frame::id, -1).all())
+      {
+        groups[f.getGroupId()].push_back(std::move(f));
+      }
+
+      for (auto& mapping : groups)
+      {
+        catalog.groups[mapping.first] =
+          std::make_shared<const std::vector<frame>>(std::move(mapping.second));
+      }
+    });
+
+    if (!catalog.groups.count(groupId))
+    {
+      return {};
+    }
+
+    return catalog.groups.at(groupId);
+  }
+
+  notion database::getNotion(int id) const
+  {
+    {
+      std::lock_guard<std::mutex> lock(notionCache_->mutex);
+
+      if (notionCache_->positions.count(id))
+      {
+        auto it = notionCache_->positions.at(id);
 
-    for (hatkirby::row& r : rows)
+        // Move the entry to the front of the list, which is ordered by how
+        // recently each notion was used.
+        notionCache_->entries.splice(
+          std::begin(notionCache_->entries),
+          notionCache_->entries,
+          it);
+
+        notionCache_->stats.hits++;
+
+        return *it;
+      }
+
+      notionCache_->stats.misses++;
+    }
+
+    notion result = notions(notion::id == id).first();
+
+    std::lock_guard<std::mutex> lock(notionCache_->mutex);
+
+    // Another thread may have loaded the same notion in the meantime.
+    if (!notionCache_->positions.count(id) && (notionCache_->capacity > 0))
     {
-      result.emplace(std::move(std::get<std::string>(r[0])));
+      notionCache_->entries.push_front(result);
+      notionCache_->positions[id] = std::begin(notionCache_->entries);
+
+      while (notionCache_->entries.size() > notionCache_->capacity)
+      {
+        notionCache_->positions.erase(notionCache_->entries.back().getId());
+        notionCache_->entries.pop_back();
+      }
     }
 
     return result;
   }
 
-  std::set<std::string> database::synrestrs(int partId) const
+  database::cache_statistics database::getNotionCacheStatistics() const
+  {
+    std::lock_guard<std::mutex> lock(notionCache_->mutex);
+
+    return notionCache_->stats;
+  }
+
+  void database::setNotionCacheCapacity(size_t capacity)
   {
-    std::vector<hatkirby::row> rows =
-      ppdb_.queryAll(
-        "SELECT synrestr FROM synrestrs WHERE part_id = ?",
-        { partId });
+    std::lock_guard<std::mutex> lock(notionCache_->mutex);
+
+    notionCache_->capacity = capacity;
+
+    while (notionCache_->entries.size() > notionCache_->capacity)
+    {
+      notionCache_->positions.erase(notionCache_->entries.back().getId());
+      notionCache_->entries.pop_back();
+    }
+  }
+
+  restriction_set database::selrestr(const std::string& name) const
+  {
+    restriction_set result;
+
+    if (selrestrBits_.count(name))
+    {
+      result.set(selrestrBits_.at(name));
+    }
 
+    return result;
+  }
+
+  restriction_set database::synrestr(const std::string& name) const
+  {
+    restriction_set result;
+
+    if (synrestrBits_.count(name))
+    {
+      result.set(synrestrBits_.at(name));
+    }
+
+    return result;
+  }
+
+  std::set<std::string> database::selrestrNames(restriction_set selrestrs) const
+  {
+    std::set<std::string> result;
+
+    for (const auto& mapping : selrestrBits_)
+    {
+      if (selrestrs.test(mapping.second))
+      {
+        result.insert(mapping.first);
+      }
+    }
+
+    return result;
+  }
+
+  std::set<std::string> database::synrestrNames(restriction_set synrestrs) const
+  {
     std::set<std::string> result;
 
-    for (hatkirby::row& r : rows)
+    for (const auto& mapping : synrestrBits_)
     {
-      result.emplace(std::move(std::get<std::string>(r[0])));
+      if (synrestrs.test(mapping.second))
+      {
+        result.insert(mapping.first);
+      }
     }
 
     return result;
@@ -4,6 +4,13 @@
 #include <string>
 #include <stdexcept>
 #include <set>
+#include <map>
+#include <tuple>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <unordered_map>
 #include <hkutil/database.h>
 #include "notion.h"
 #include "word.h"
@@ -12,6 +19,10 @@
 #include "form.h"
 #include "pronunciation.h"
 #include "order.h"
+#include "statistics.h"
+#include "restriction.h"
+#include "bitmap_index.h"
+#include "connection.h"
 
 namespace verbly {
 
@@ -23,7 +34,13 @@ namespace verbly {
 
     // Constructor
 
-    explicit database(std::string path);
+    /**
+     * If bitmapIndex is true, an in-memory bitmap index of low-cardinality
+     * attributes is built when the database is opened. Randomly ordered
+     * queries whose filters only test those attributes are then sampled from
+     * the index instead of scanned for by SQLite.
+     */
+    explicit database(std::string path, bool bitmapIndex = false);
 
     // Information
 
@@ -69,17 +86,129 @@ namespace verbly {
       order sortOrder = {},
       int limit = 1) const;
 
-    std::set<std::string> selrestrs(int partId) const;
+    // Restrictions
+
+    /**
+     * Returns the restriction set containing just the named selectional or
+     * syntactic restriction, or an empty set if no part in the datafile uses
+     * that restriction.
+     */
+    restriction_set selrestr(const std::string& name) const;
+
+    restriction_set synrestr(const std::string& name) const;
+
+    std::set<std::string> selrestrNames(restriction_set selrestrs) const;
+
+    std::set<std::string> synrestrNames(restriction_set synrestrs) const;
+
+    // Notions
+
+    /**
+     * Notions are shared by every word in a synset, so the database keeps a
+     * bounded, thread-safe identity map of the notions it has loaded, which is
+     * used whenever a word is read. This returns the notion with the given ID,
+     * loading it if it is not already cached.
+     */
+    notion getNotion(int id) const;
+
+    struct cache_statistics {
+      size_t hits = 0;
+      size_t misses = 0;
+
+      double getHitRate() const
+      {
+        return (hits + misses) ? (static_cast<double>(hits) / (hits + misses)) : 0.0;
+      }
+    };
+
+    cache_statistics getNotionCacheStatistics() const;
+
+    // Sets the maximum number of notions to keep in memory. The least recently
+    // used notions are evicted first.
+    void setNotionCacheCapacity(size_t capacity);
+
+    // Forms
+
+    /**
+     * Returns the forms of each of the given lemmas in each of the given
+     * inflection categories, keyed by lemma ID and category, and ordered by
+     * form ID.
+     */
+    std::map<std::tuple<int, inflection>, std::vector<form>> getLemmaForms(
+      const std::set<int>& lemmaIds,
+      const std::set<inflection>& categories) const;
+
+    // Frames
+
+    /**
+     * The frames of a VerbNet group are shared by every word in the group, so
+     * all of them are loaded once, the first time any group's frames are
+     * requested. This returns the frames of the given group, or null if it has
+     * none.
+     */
+    std::shared_ptr<const std::vector<frame>> getGroupFrames(int groupId) const;
+
+    // Query planning
+
+    /**
+     * By default, queries use the statistics stored in the datafile to order
+     * their conditions so that the most selective ones are evaluated first.
+     * Disabling this causes conditions to be evaluated in the order that they
+     * appear in the filter, which is useful when comparing query plans.
+     */
+    void setFilterReordering(bool enabled)
+    {
+      reorderFilters_ = enabled;
+    }
 
-    std::set<std::string> synrestrs(int partId) const;
+    bool isFilterReordering() const
+    {
+      return reorderFilters_;
+    }
+
+    const statistics& getStatistics() const
+    {
+      return stats_;
+    }
 
   private:
 
+    const statistics* getPlanningStatistics() const
+    {
+      return reorderFilters_ ? &stats_ : nullptr;
+    }
+
     mutable hatkirby::database ppdb_;
+    connection conn_;
 
     int major_;
     int minor_;
 
+    statistics stats_;
+    bool reorderFilters_ = true;
+
+    bitmap_index index_;
+
+    struct frame_catalog {
+      std::once_flag loaded;
+      std::map<int, std::shared_ptr<const std::vector<frame>>> groups;
+    };
+
+    std::unique_ptr<frame_catalog> frameCatalog_ = std::make_unique<frame_catalog>();
+
+    std::map<std::string, int> selrestrBits_;
+    std::map<std::string, int> synrestrBits_;
+
+    struct notion_cache {
+      std::mutex mutex;
+      size_t capacity = 4096;
+      std::list<notion> entries;
+      std::unordered_map<int, std::list<notion>::iterator> positions;
+      cache_statistics stats;
+    };
+
+    std::unique_ptr<notion_cache> notionCache_ = std::make_unique<notion_cache>();
+
   };
 
   class database_version_mismatch : public std::logic_error {
@@ -26,7 +26,7 @@ namespace verbly {
     past_tense = 4,
     past_participle = 5,
     ing_form = 6,
-    s_form = 7
+    s_form = 7 // word::inflectionCount assumes this is the last category
   };
 
   enum class object {
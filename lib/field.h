@@ -4,6 +4,7 @@
 #include "enums.h"
 #include <stdexcept>
 #include <tuple>
+#include <functional>
 
 namespace verbly {
 
@@ -282,6 +283,21 @@ namespace verbly {
         == std::tie(other.object_, other.column_, other.table_, other.joinColumn_, other.conditionColumn_, other.conditionValue_);
     }
 
+    // Hashing
+
+    size_t hash() const
+    {
+      // See operator<() for documentation.
+      size_t result = std::hash<int>()(static_cast<int>(object_));
+      result = (result * 31) + std::hash<const char*>()(column_);
+      result = (result * 31) + std::hash<const char*>()(table_);
+      result = (result * 31) + std::hash<const char*>()(joinColumn_);
+      result = (result * 31) + std::hash<const char*>()(conditionColumn_);
+      result = (result * 31) + std::hash<int>()(conditionValue_);
+
+      return result;
+    }
+
     // Filter construction
 
     filter operator==(int value) const; // Integer equality
@@ -371,4 +387,16 @@ namespace verbly {
 
 };
 
+namespace std {
+
+  template <>
+  struct hash<verbly::field> {
+    size_t operator()(const verbly::field& arg) const
+    {
+      return arg.hash();
+    }
+  };
+
+};
+
 #endif /* end of include guard: FIELD_H_43258321 */
@@ -1,6 +1,7 @@
 #include "filter.h"
 #include <stdexcept>
 #include <map>
+#include <algorithm>
 #include "notion.h"
 #include "word.h"
 #include "frame.h"
@@ -27,12 +28,12 @@ namespace verbly {
         case comparison::int_is_at_most:
         case comparison::int_is_less_than:
         {
-          variant_ = singleton_type
+          variant_ = std::make_shared<variant_type>(singleton_type
             {
               std::move(filterField),
               filterType,
               filterValue
-            };
+            });
 
           break;
         }
@@ -75,12 +76,12 @@ namespace verbly {
         case comparison::string_is_like:
         case comparison::string_is_not_like:
         {
-          variant_ = singleton_type
+          variant_ = std::make_shared<variant_type>(singleton_type
             {
               std::move(filterField),
               filterType,
               std::move(filterValue)
-            };
+            });
 
           break;
         }
@@ -122,12 +123,12 @@ namespace verbly {
       {
         case comparison::boolean_equals:
         {
-          variant_ = singleton_type
+          variant_ = std::make_shared<variant_type>(singleton_type
             {
               std::move(filterField),
               filterType,
               filterValue
-            };
+            });
 
           break;
         }
@@ -172,11 +173,11 @@ namespace verbly {
         case comparison::is_null:
         case comparison::is_not_null:
         {
-          variant_ = singleton_type
+          variant_ = std::make_shared<variant_type>(singleton_type
             {
               std::move(filterField),
               filterType
-            };
+            });
 
           break;
         }
@@ -227,12 +228,12 @@ namespace verbly {
           case comparison::matches:
           case comparison::does_not_match:
           {
-            variant_ = singleton_type
+            variant_ = std::make_shared<variant_type>(singleton_type
               {
                 std::move(joinOn),
                 filterType,
-                rec_filter(new filter(std::move(joinCondition)))
-              };
+                std::make_shared<const filter>(std::move(joinCondition))
+              });
 
             break;
           }
@@ -270,12 +271,12 @@ namespace verbly {
           case comparison::hierarchally_matches:
           case comparison::does_not_hierarchally_match:
           {
-            variant_ = singleton_type
+            variant_ = std::make_shared<variant_type>(singleton_type
               {
                 std::move(joinOn),
                 filterType,
-                rec_filter(new filter(std::move(joinCondition)))
-              };
+                std::make_shared<const filter>(std::move(joinCondition))
+              });
 
             break;
           }
@@ -337,12 +338,12 @@ namespace verbly {
           throw std::domain_error("Cannot compare join fields");
         }
 
-        variant_ = singleton_type
+        variant_ = std::make_shared<variant_type>(singleton_type
           {
             std::move(filterField),
             filterType,
             std::move(compareField)
-          };
+          });
 
         break;
       }
@@ -377,7 +378,7 @@ namespace verbly {
       throw std::domain_error("This filter does not have a field");
     }
 
-    return std::get<singleton_type>(variant_).filterField;
+    return std::get<singleton_type>(*variant_).filterField;
   }
 
   filter::comparison filter::getComparison() const
@@ -387,7 +388,7 @@ namespace verbly {
       throw std::domain_error("This filter does not have a comparison");
     }
 
-    return std::get<singleton_type>(variant_).filterType;
+    return std::get<singleton_type>(*variant_).filterType;
   }
 
   filter filter::getJoinCondition() const
@@ -397,7 +398,7 @@ namespace verbly {
       throw std::domain_error("This filter does not have a join condition");
     }
 
-    const singleton_type& ss = std::get<singleton_type>(variant_);
+    const singleton_type& ss = std::get<singleton_type>(*variant_);
 
     switch (ss.filterType)
     {
@@ -437,7 +438,7 @@ namespace verbly {
       throw std::domain_error("This filter does not have a string argument");
     }
 
-    const singleton_type& ss = std::get<singleton_type>(variant_);
+    const singleton_type& ss = std::get<singleton_type>(*variant_);
 
     switch (ss.filterType)
     {
@@ -477,7 +478,7 @@ namespace verbly {
       throw std::domain_error("This filter does not have an integer argument");
     }
 
-    const singleton_type& ss = std::get<singleton_type>(variant_);
+    const singleton_type& ss = std::get<singleton_type>(*variant_);
 
     switch (ss.filterType)
     {
@@ -514,13 +515,13 @@ namespace verbly {
   bool filter::getBooleanArgument() const
   {
     if ((type_ != type::singleton) ||
-      (std::get<singleton_type>(variant_).filterType !=
+      (std::get<singleton_type>(*variant_).filterType !=
         comparison::boolean_equals))
     {
       throw std::domain_error("This filter does not have a boolean argument");
     }
 
-    return std::get<bool>(std::get<singleton_type>(variant_).data);
+    return std::get<bool>(std::get<singleton_type>(*variant_).data);
   }
 
   field filter::getCompareField() const
@@ -530,7 +531,7 @@ namespace verbly {
       throw std::domain_error("This filter does not have a compare field");
     }
 
-    const singleton_type& ss = std::get<singleton_type>(variant_);
+    const singleton_type& ss = std::get<singleton_type>(*variant_);
 
     switch (ss.filterType)
     {
@@ -568,7 +569,7 @@ namespace verbly {
 
   filter::filter(bool orlogic) :
     type_(type::group),
-    variant_(group_type {{}, orlogic})
+    variant_(std::make_shared<variant_type>(group_type {{}, orlogic}))
   {
   }
 
@@ -579,7 +580,7 @@ namespace verbly {
       throw std::domain_error("This filter is not a group filter");
     }
 
-    return std::get<group_type>(variant_).orlogic;
+    return std::get<group_type>(*variant_).orlogic;
   }
 
   filter filter::operator+(filter condition) const
@@ -597,7 +598,7 @@ namespace verbly {
       throw std::domain_error("Children can only be added to group filters");
     }
 
-    std::get<group_type>(variant_).children.push_back(std::move(condition));
+    std::get<group_type>(mutableVariant()).children.push_back(std::move(condition));
 
     return *this;
   }
@@ -609,7 +610,7 @@ namespace verbly {
       throw std::domain_error("This filter has no children");
     }
 
-    return std::begin(std::get<group_type>(variant_).children);
+    return std::begin(std::get<group_type>(*variant_).children);
   }
 
   filter::const_iterator filter::end() const
@@ -619,7 +620,7 @@ namespace verbly {
       throw std::domain_error("This filter has no children");
     }
 
-    return std::end(std::get<group_type>(variant_).children);
+    return std::end(std::get<group_type>(*variant_).children);
   }
 
   filter::filter(
@@ -627,11 +628,11 @@ namespace verbly {
     bool internal,
     filter subfilter) :
       type_(type::mask),
-      variant_(mask_type {
+      variant_(std::make_shared<variant_type>(mask_type {
         std::move(name),
         internal,
-        rec_filter(new filter(std::move(subfilter)))
-      })
+        std::make_shared<const filter>(std::move(subfilter))
+      }))
   {
   }
 
@@ -642,7 +643,7 @@ namespace verbly {
       throw std::domain_error("This filter is not a mask filter");
     }
 
-    return std::get<mask_type>(variant_).name;
+    return std::get<mask_type>(*variant_).name;
   }
 
   bool filter::isMaskInternal() const
@@ -652,7 +653,7 @@ namespace verbly {
       throw std::domain_error("This filter is not a mask filter");
     }
 
-    return std::get<mask_type>(variant_).internal;
+    return std::get<mask_type>(*variant_).internal;
   }
 
   const filter& filter::getMaskFilter() const
@@ -662,7 +663,7 @@ namespace verbly {
       throw std::domain_error("This filter is not a mask filter");
     }
 
-    return *std::get<mask_type>(variant_).subfilter;
+    return *std::get<mask_type>(*variant_).subfilter;
   }
 
   filter filter::operator!() const
@@ -676,7 +677,7 @@ namespace verbly {
 
       case type::singleton:
       {
-        const singleton_type& ss = std::get<singleton_type>(variant_);
+        const singleton_type& ss = std::get<singleton_type>(*variant_);
 
         switch (ss.filterType)
         {
@@ -834,7 +835,7 @@ namespace verbly {
 
       case type::group:
       {
-        const group_type& gg = std::get<group_type>(variant_);
+        const group_type& gg = std::get<group_type>(*variant_);
 
         filter result(!gg.orlogic);
 
@@ -848,7 +849,7 @@ namespace verbly {
 
       case type::mask:
       {
-        const mask_type& mm = std::get<mask_type>(variant_);
+        const mask_type& mm = std::get<mask_type>(*variant_);
 
         return {mm.name, mm.internal, !*mm.subfilter};
       }
@@ -857,15 +858,15 @@ namespace verbly {
 
   filter& filter::operator&=(filter condition)
   {
-    return (*this = (*this && std::move(condition)));
+    return (*this = (std::move(*this) && std::move(condition)));
   }
 
   filter& filter::operator|=(filter condition)
   {
-    return (*this = (*this || std::move(condition)));
+    return (*this = (std::move(*this) || std::move(condition)));
   }
 
-  filter filter::operator&&(filter condition) const
+  filter filter::operator&&(filter condition) const &
   {
     switch (type_)
     {
@@ -879,7 +880,7 @@ namespace verbly {
       {
         filter result(false);
 
-        group_type& gg = std::get<group_type>(result.variant_);
+        group_type& gg = std::get<group_type>(result.mutableVariant());
 
         gg.children.push_back(*this);
         gg.children.push_back(std::move(condition));
@@ -889,13 +890,13 @@ namespace verbly {
 
       case type::group:
       {
-        const group_type& og = std::get<group_type>(variant_);
+        const group_type& og = std::get<group_type>(*variant_);
 
         if (og.orlogic)
         {
           filter result(false);
 
-          group_type& gg = std::get<group_type>(result.variant_);
+          group_type& gg = std::get<group_type>(result.mutableVariant());
 
           gg.children.push_back(*this);
           gg.children.push_back(std::move(condition));
@@ -904,7 +905,7 @@ namespace verbly {
         } else {
           filter result(*this);
 
-          group_type& gg = std::get<group_type>(result.variant_);
+          group_type& gg = std::get<group_type>(result.mutableVariant());
 
           gg.children.push_back(std::move(condition));
 
@@ -914,7 +915,7 @@ namespace verbly {
     }
   }
 
-  filter filter::operator||(filter condition) const
+  filter filter::operator||(filter condition) const &
   {
     switch (type_)
     {
@@ -928,7 +929,7 @@ namespace verbly {
       {
         filter result(true);
 
-        group_type& gg = std::get<group_type>(result.variant_);
+        group_type& gg = std::get<group_type>(result.mutableVariant());
 
         gg.children.push_back(*this);
         gg.children.push_back(std::move(condition));
@@ -938,13 +939,13 @@ namespace verbly {
 
       case type::group:
       {
-        const group_type& og = std::get<group_type>(variant_);
+        const group_type& og = std::get<group_type>(*variant_);
 
         if (!og.orlogic)
         {
           filter result(true);
 
-          group_type& gg = std::get<group_type>(result.variant_);
+          group_type& gg = std::get<group_type>(result.mutableVariant());
 
           gg.children.push_back(*this);
           gg.children.push_back(std::move(condition));
@@ -953,7 +954,7 @@ namespace verbly {
         } else {
           filter result(*this);
 
-          group_type& gg = std::get<group_type>(result.variant_);
+          group_type& gg = std::get<group_type>(result.mutableVariant());
 
           gg.children.push_back(std::move(condition));
 
@@ -963,6 +964,30 @@ namespace verbly {
     }
   }
 
+  filter filter::operator&&(filter condition) &&
+  {
+    if ((type_ == type::group) && !std::get<group_type>(*variant_).orlogic)
+    {
+      *this += std::move(condition);
+
+      return std::move(*this);
+    } else {
+      return static_cast<const filter&>(*this) && std::move(condition);
+    }
+  }
+
+  filter filter::operator||(filter condition) &&
+  {
+    if ((type_ == type::group) && std::get<group_type>(*variant_).orlogic)
+    {
+      *this += std::move(condition);
+
+      return std::move(*this);
+    } else {
+      return static_cast<const filter&>(*this) || std::move(condition);
+    }
+  }
+
   filter filter::mask(std::string name, filter subfilter)
   {
     return {std::move(name), false, std::move(subfilter)};
@@ -980,7 +1005,7 @@ namespace verbly {
 
         case type::singleton:
         {
-          const singleton_type& ss = std::get<singleton_type>(variant_);
+          const singleton_type& ss = std::get<singleton_type>(*variant_);
 
           // First, switch on the normalized context, and then switch on the
           // current context. We recursively recontextualize by using the
@@ -1147,16 +1172,54 @@ namespace verbly {
 
         case type::group:
         {
-          const group_type& gg = std::get<group_type>(variant_);
+          const group_type& gg = std::get<group_type>(*variant_);
+
+          // A group that is already normal is shared rather than rebuilt. If
+          // it is not, the children before the first one that changes are
+          // already normal, and are reused below without normalizing them
+          // again.
+          const_iterator changed = std::begin(gg.children);
+          filter changedNormalized;
+
+          for (; changed != std::end(gg.children); changed++)
+          {
+            changedNormalized = changed->normalize(context);
+
+            if ((changedNormalized.variant_ != changed->variant_)
+              || !isNormalChild(changed, context))
+            {
+              break;
+            }
+          }
+
+          if (changed == std::end(gg.children))
+          {
+            return *this;
+          }
 
           filter result(gg.orlogic);
           std::map<field, filter> positiveJoins;
           std::map<field, filter> negativeJoins;
           std::map<std::tuple<std::string, bool>, filter> masks;
 
-          for (const filter& child : gg.children)
+          bool checked = true;
+
+          for (const_iterator it = std::begin(gg.children);
+            it != std::end(gg.children);
+            it++)
           {
-            filter normalized = child.normalize(context);
+            filter normalized;
+
+            if (it == changed)
+            {
+              normalized = std::move(changedNormalized);
+              checked = false;
+            } else if (checked)
+            {
+              normalized = *it;
+            } else {
+              normalized = it->normalize(context);
+            }
 
             // Notably, this does not attempt to merge hierarchal matches,
             // UNLESS they are positive matches being OR-d, or negative
@@ -1165,8 +1228,8 @@ namespace verbly {
             {
               case type::singleton:
               {
-                singleton_type& normSing =
-                  std::get<singleton_type>(normalized.variant_);
+                const singleton_type& normSing =
+                  std::get<singleton_type>(*normalized.variant_);
 
                 switch (normalized.getComparison())
                 {
@@ -1178,7 +1241,7 @@ namespace verbly {
                     }
 
                     positiveJoins.at(normalized.getField()) +=
-                      std::move(*std::get<rec_filter>(normSing.data));
+                      *std::get<rec_filter>(normSing.data);
 
                     break;
                   }
@@ -1192,7 +1255,7 @@ namespace verbly {
                     }
 
                     negativeJoins.at(normalized.getField()) +=
-                      std::move(*std::get<rec_filter>(normSing.data));
+                      *std::get<rec_filter>(normSing.data);
 
                     break;
                   }
@@ -1202,7 +1265,7 @@ namespace verbly {
                     if (gg.orlogic)
                     {
                       positiveJoins[normalized.getField()] |=
-                        std::move(*std::get<rec_filter>(normSing.data));
+                        *std::get<rec_filter>(normSing.data);
                     } else {
                       result += std::move(normalized);
                     }
@@ -1215,7 +1278,7 @@ namespace verbly {
                     if (!gg.orlogic)
                     {
                       negativeJoins[normalized.getField()] |=
-                        std::move(*std::get<rec_filter>(normSing.data));
+                        *std::get<rec_filter>(normSing.data);
                     } else {
                       result += std::move(normalized);
                     }
@@ -1258,8 +1321,8 @@ namespace verbly {
 
               case type::mask:
               {
-                mask_type& normMask =
-                  std::get<mask_type>(normalized.variant_);
+                const mask_type& normMask =
+                  std::get<mask_type>(*normalized.variant_);
 
                 auto maskId =
                   std::tie(
@@ -1271,7 +1334,7 @@ namespace verbly {
                   masks[maskId] = filter(gg.orlogic);
                 }
 
-                masks.at(maskId) += std::move(*normMask.subfilter);
+                masks.at(maskId) += *normMask.subfilter;
 
                 break;
               }
@@ -1305,22 +1368,131 @@ namespace verbly {
             result += {name, internal, std::move(subfilter)};
           }
 
+          // Repeating a child has no effect on either an AND or an OR group,
+          // but each copy would be compiled into the query and evaluated
+          // separately, so we remove structurally identical children.
+          std::list<filter>& children =
+            std::get<group_type>(result.mutableVariant()).children;
+
+          for (auto it = std::begin(children); it != std::end(children); it++)
+          {
+            children.erase(
+              std::remove(std::next(it), std::end(children), *it),
+              std::end(children));
+          }
+
           return result;
         }
 
         case type::mask:
         {
-          const mask_type& mm = std::get<mask_type>(variant_);
+          const mask_type& mm = std::get<mask_type>(*variant_);
+
+          filter subfilter = mm.subfilter->normalize(context);
+
+          if (subfilter.variant_ == mm.subfilter->variant_)
+          {
+            return *this;
+          }
 
           return {
             mm.name,
             mm.internal,
-            mm.subfilter->normalize(context)};
+            std::move(subfilter)};
         }
       }
     }
   }
 
+  /**
+   * Normalizing a group merges its joins through the same field, and its masks
+   * with the same name, and removes duplicate children. Join conditions are
+   * also normalized in the context of the joined object. A child that none of
+   * this applies to is kept as it is.
+   */
+  bool filter::isNormalChild(const_iterator child, object context) const
+  {
+    const group_type& gg = std::get<group_type>(*variant_);
+
+    // Positive joins are merged with each other, as are negative joins.
+    // Hierarchal matches are only merged when they are positive in an OR
+    // group or negative in an AND group.
+    auto joinPolarity = [&] (const filter& arg) {
+      if (arg.type_ != type::singleton)
+      {
+        return 0;
+      }
+
+      switch (arg.getComparison())
+      {
+        case comparison::matches: return 1;
+        case comparison::does_not_match: return -1;
+        case comparison::hierarchally_matches: return gg.orlogic ? 1 : 0;
+        case comparison::does_not_hierarchally_match: return gg.orlogic ? 0 : -1;
+
+        case comparison::int_equals:
+        case comparison::int_does_not_equal:
+        case comparison::int_is_at_least:
+        case comparison::int_is_greater_than:
+        case comparison::int_is_at_most:
+        case comparison::int_is_less_than:
+        case comparison::boolean_equals:
+        case comparison::string_equals:
+        case comparison::string_does_not_equal:
+        case comparison::string_is_like:
+        case comparison::string_is_not_like:
+        case comparison::is_null:
+        case comparison::is_not_null:
+        case comparison::field_equals:
+        case comparison::field_does_not_equal:
+        {
+          return 0;
+        }
+      }
+
+      throw std::logic_error("Invalid comparison type");
+    };
+
+    int polarity = joinPolarity(*child);
+
+    if (polarity != 0)
+    {
+      const singleton_type& cs = std::get<singleton_type>(*child->variant_);
+      const filter& condition = *std::get<rec_filter>(cs.data);
+
+      if (condition.normalize(cs.filterField.getJoinObject()).variant_
+        != condition.variant_)
+      {
+        return false;
+      }
+    }
+
+    for (const_iterator it = std::begin(gg.children); it != child; it++)
+    {
+      if (*it == *child)
+      {
+        return false;
+      }
+
+      if ((polarity != 0)
+        && (joinPolarity(*it) == polarity)
+        && (it->getField() == child->getField()))
+      {
+        return false;
+      }
+
+      if ((child->type_ == type::mask)
+        && (it->type_ == type::mask)
+        && (it->getMaskName() == child->getMaskName())
+        && (it->isMaskInternal() == child->isMaskInternal()))
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
   filter filter::compact() const
   {
     switch (type_)
@@ -1333,26 +1505,47 @@ namespace verbly {
 
       case type::group:
       {
-        const group_type& gg = std::get<group_type>(variant_);
+        const group_type& gg = std::get<group_type>(*variant_);
+
+        // A group with more than one child, none of which are empty, is kept
+        // as it is. Otherwise, the children before the first empty one are
+        // kept without compacting them again.
+        const_iterator firstEmpty = std::begin(gg.children);
+        while ((firstEmpty != std::end(gg.children))
+          && (firstEmpty->compact().type_ != type::empty))
+        {
+          firstEmpty++;
+        }
+
+        if ((firstEmpty == std::end(gg.children)) && (gg.children.size() > 1))
+        {
+          return *this;
+        }
 
         filter result(gg.orlogic);
-        for (const filter& child : gg.children)
+        bool checked = true;
+
+        for (const_iterator it = std::begin(gg.children);
+          it != std::end(gg.children);
+          it++)
         {
-          filter compactedChild = child.compact();
-          if (compactedChild.type_ != type::empty)
+          if (it == firstEmpty)
+          {
+            checked = false;
+          } else if (checked || (it->compact().type_ != type::empty))
           {
-            result += child;
+            result += *it;
           }
         }
 
-        group_type& resGroup = std::get<group_type>(result.variant_);
+        const group_type& resGroup = std::get<group_type>(*result.variant_);
 
         if (resGroup.children.empty())
         {
           result = {};
         } else if (resGroup.children.size() == 1)
         {
-          filter tempChild = std::move(resGroup.children.front());
+          filter tempChild = resGroup.children.front();
 
           result = std::move(tempChild);
         }
@@ -1362,13 +1555,16 @@ namespace verbly {
 
       case type::mask:
       {
-        const mask_type& mm = std::get<mask_type>(variant_);
+        const mask_type& mm = std::get<mask_type>(*variant_);
 
         filter subfilter = mm.subfilter->compact();
 
         if (subfilter.type_ == type::empty)
         {
           return {};
+        } else if (subfilter.variant_ == mm.subfilter->variant_)
+        {
+          return *this;
         } else {
           return {
             mm.name,
@@ -1379,4 +1575,166 @@ namespace verbly {
     }
   }
 
+  bool filter::operator==(const filter& other) const
+  {
+    if (type_ != other.type_)
+    {
+      return false;
+    }
+
+    // Filters that share a node are trivially equal.
+    if (variant_ == other.variant_)
+    {
+      return true;
+    }
+
+    switch (type_)
+    {
+      case type::empty:
+      {
+        return true;
+      }
+
+      case type::singleton:
+      {
+        const singleton_type& ss = std::get<singleton_type>(*variant_);
+        const singleton_type& os = std::get<singleton_type>(*other.variant_);
+
+        if ((ss.filterType != os.filterType)
+          || !(ss.filterField == os.filterField)
+          || (ss.data.index() != os.data.index()))
+        {
+          return false;
+        }
+
+        if (std::holds_alternative<rec_filter>(ss.data))
+        {
+          return (*std::get<rec_filter>(ss.data)
+            == *std::get<rec_filter>(os.data));
+        } else if (std::holds_alternative<std::string>(ss.data))
+        {
+          return (std::get<std::string>(ss.data)
+            == std::get<std::string>(os.data));
+        } else if (std::holds_alternative<int>(ss.data))
+        {
+          return (std::get<int>(ss.data) == std::get<int>(os.data));
+        } else if (std::holds_alternative<bool>(ss.data))
+        {
+          return (std::get<bool>(ss.data) == std::get<bool>(os.data));
+        } else if (std::holds_alternative<field>(ss.data))
+        {
+          return (std::get<field>(ss.data) == std::get<field>(os.data));
+        } else {
+          return true;
+        }
+      }
+
+      case type::group:
+      {
+        const group_type& gg = std::get<group_type>(*variant_);
+        const group_type& og = std::get<group_type>(*other.variant_);
+
+        return (gg.orlogic == og.orlogic) && (gg.children == og.children);
+      }
+
+      case type::mask:
+      {
+        const mask_type& mm = std::get<mask_type>(*variant_);
+        const mask_type& om = std::get<mask_type>(*other.variant_);
+
+        return (mm.name == om.name)
+          && (mm.internal == om.internal)
+          && (*mm.subfilter == *om.subfilter);
+      }
+    }
+
+    throw std::logic_error("Invalid filter type");
+  }
+
+  size_t filter::hash() const
+  {
+    size_t result = std::hash<int>()(static_cast<int>(type_));
+
+    switch (type_)
+    {
+      case type::empty:
+      {
+        break;
+      }
+
+      case type::singleton:
+      {
+        const singleton_type& ss = std::get<singleton_type>(*variant_);
+
+        result = (result * 31) + ss.filterField.hash();
+        result = (result * 31) + std::hash<int>()(static_cast<int>(ss.filterType));
+
+        if (std::holds_alternative<rec_filter>(ss.data))
+        {
+          result = (result * 31) + std::get<rec_filter>(ss.data)->hash();
+        } else if (std::holds_alternative<std::string>(ss.data))
+        {
+          result = (result * 31) + std::hash<std::string>()(std::get<std::string>(ss.data));
+        } else if (std::holds_alternative<int>(ss.data))
+        {
+          result = (result * 31) + std::hash<int>()(std::get<int>(ss.data));
+        } else if (std::holds_alternative<bool>(ss.data))
+        {
+          result = (result * 31) + std::hash<bool>()(std::get<bool>(ss.data));
+        } else if (std::holds_alternative<field>(ss.data))
+        {
+          result = (result * 31) + std::get<field>(ss.data).hash();
+        }
+
+        break;
+      }
+
+      case type::group:
+      {
+        const group_type& gg = std::get<group_type>(*variant_);
+
+        result = (result * 31) + std::hash<bool>()(gg.orlogic);
+
+        for (const filter& child : gg.children)
+        {
+          result = (result * 31) + child.hash();
+        }
+
+        break;
+      }
+
+      case type::mask:
+      {
+        const mask_type& mm = std::get<mask_type>(*variant_);
+
+        result = (result * 31) + std::hash<std::string>()(mm.name);
+        result = (result * 31) + std::hash<bool>()(mm.internal);
+        result = (result * 31) + mm.subfilter->hash();
+
+        break;
+      }
+    }
+
+    return result;
+  }
+
+  filter::variant_type& filter::mutableVariant()
+  {
+    if (variant_.use_count() > 1)
+    {
+      variant_ = std::make_shared<variant_type>(*variant_);
+    }
+
+    return *variant_;
+  }
+
+};
+
+namespace std {
+
+  size_t hash<verbly::filter>::operator()(const verbly::filter& arg) const
+  {
+    return arg.hash();
+  }
+
 };
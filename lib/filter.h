@@ -5,7 +5,7 @@
 #include <string>
 #include <memory>
 #include <variant>
-#include "../vendor/hkutil/hkutil/recptr.h"
+#include <functional>
 #include "field.h"
 #include "enums.h"
 
@@ -109,8 +109,14 @@ namespace verbly {
 
     // Groupifying
 
-    filter operator&&(filter condition) const;
-    filter operator||(filter condition) const;
+    filter operator&&(filter condition) const &;
+    filter operator||(filter condition) const &;
+
+    // These overloads append to a temporary group in place rather than
+    // copying its children, so that chains like (a && b && c) build a single
+    // group.
+    filter operator&&(filter condition) &&;
+    filter operator||(filter condition) &&;
 
     filter& operator&=(filter condition);
     filter& operator|=(filter condition);
@@ -125,9 +131,24 @@ namespace verbly {
 
     filter compact() const;
 
+    // Equality
+
+    bool operator==(const filter& other) const;
+
+    bool operator!=(const filter& other) const
+    {
+      return !(*this == other);
+    }
+
+    // Hashing
+
+    size_t hash() const;
+
   private:
 
-    using rec_filter = hatkirby::recptr<filter>;
+    // Filter nodes are immutable once they are shared, so copying a filter
+    // (or a subtree of one) only increments a reference count.
+    using rec_filter = std::shared_ptr<const filter>;
 
     struct singleton_type {
       field filterField;
@@ -160,9 +181,26 @@ namespace verbly {
         group_type,
         mask_type>;
 
+    // Returns a modifiable reference to this filter's node, first copying the
+    // node if it is shared with any other filter.
+    variant_type& mutableVariant();
+
+    // Returns whether normalizing this group would keep the given child as it
+    // is, provided that the child normalizes to itself.
+    bool isNormalChild(const_iterator child, object context) const;
+
     type type_ = type::empty;
-    variant_type variant_;
+    std::shared_ptr<variant_type> variant_;
+
+  };
+
+};
+
+namespace std {
 
+  template <>
+  struct hash<verbly::filter> {
+    size_t operator()(const verbly::filter& arg) const;
   };
 
 };
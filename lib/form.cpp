@@ -23,29 +23,35 @@ namespace verbly {
     return field::joinThroughWhere(object::form, "form_id", object::word, "lemmas_forms", "lemma_id", "category", static_cast<int>(category));
   }
 
-  form::form(const database& db, hatkirby::row row) : valid_(true)
+  form::form(const database& db, const cursor& columns)
   {
-    id_ = std::get<int>(row[0]);
-    text_ = std::get<std::string>(row[1]);
-    complexity_ = std::get<int>(row[2]);
-    proper_ = (std::get<int>(row[3]) == 1);
-    length_ = std::get<int>(row[4]);
+    std::shared_ptr<state_type> state = std::make_shared<state_type>();
 
-    pronunciations_ = db.pronunciations(*this, pronunciation::id, -1).all();
+    state->id = columns.getInteger(0);
+    state->text = columns.getString(1);
+    state->complexity = columns.getInteger(2);
+    state->proper = columns.getBoolean(3);
+    state->length = columns.getInteger(4);
+
+    state->pronunciations = db.pronunciations(form::id == state->id, pronunciation::id, -1).all();
+
+    state_ = std::move(state);
   }
 
   bool form::startsWithVowelSound() const
   {
-    if (!valid_)
+    if (!state_)
     {
       throw std::domain_error("Bad access to uninitialized form");
     }
 
-    if (!pronunciations_.empty())
+    const std::vector<pronunciation>& pronunciations = state_->pronunciations;
+
+    if (!pronunciations.empty())
     {
       return std::any_of(
-        std::begin(pronunciations_),
-        std::end(pronunciations_),
+        std::begin(pronunciations),
+        std::end(pronunciations),
         [] (const pronunciation& p) {
           return p.getPhonemes().front().find_first_of("012") !=
             std::string::npos;
@@ -53,7 +59,7 @@ namespace verbly {
     } else {
       // If the word is not in CMUDICT, fall back to checking whether the first
       // letter is a vowel. Not perfect but will work in most cases.
-      char ch = std::tolower(text_.front());
+      char ch = std::tolower(state_->text.front());
       return (ch == 'a') ||
              (ch == 'e') ||
              (ch == 'i') ||
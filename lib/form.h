@@ -5,8 +5,10 @@
 #include <vector>
 #include <string>
 #include <stdexcept>
+#include <memory>
 #include <hkutil/database.h>
 #include "field.h"
+#include "connection.h"
 #include "pronunciation.h"
 #include "filter.h"
 
@@ -23,73 +25,73 @@ namespace verbly {
 
     // Construct from database
 
-    form(const database& db, hatkirby::row row);
+    form(const database& db, const cursor& columns);
 
     // Accessors
 
     bool isValid() const
     {
-      return valid_;
+      return (state_ != nullptr);
     }
 
     int getId() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized form");
       }
 
-      return id_;
+      return state_->id;
     }
 
     const std::string& getText() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized form");
       }
 
-      return text_;
+      return state_->text;
     }
 
     int getComplexity() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized form");
       }
 
-      return complexity_;
+      return state_->complexity;
     }
 
     bool isProper() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized form");
       }
 
-      return proper_;
+      return state_->proper;
     }
 
     int getLength() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized form");
       }
 
-      return length_;
+      return state_->length;
     }
 
     const std::vector<pronunciation>& getPronunciations() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized form");
       }
 
-      return pronunciations_;
+      return state_->pronunciations;
     }
 
     // Convenience
@@ -112,22 +114,22 @@ namespace verbly {
 
     operator filter() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized form");
       }
 
-      return (id == id_);
+      return (id == state_->id);
     }
 
     filter operator!() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized form");
       }
 
-      return (id != id_);
+      return (id != state_->id);
     }
 
     // Relationships to other objects
@@ -138,13 +140,18 @@ namespace verbly {
 
   private:
 
-    bool valid_ = false;
-    int id_;
-    std::string text_;
-    int complexity_;
-    bool proper_;
-    int length_;
-    std::vector<pronunciation> pronunciations_;
+    // A form is a handle to immutable state that is shared between copies, so
+    // copying a form is as cheap as copying a pointer.
+    struct state_type {
+      int id;
+      std::string text;
+      int complexity;
+      bool proper;
+      int length;
+      std::vector<pronunciation> pronunciations;
+    };
+
+    std::shared_ptr<const state_type> state_;
   };
 
 };
@@ -23,13 +23,17 @@ namespace verbly {
     return field::joinWhere(object::frame, "frame_id", object::part, "part_index", index);
   }
 
-  frame::frame(const database& db, hatkirby::row row) : valid_(true)
+  frame::frame(const database& db, const cursor& columns)
   {
-    id_ = std::get<int>(row[0]);
-    groupId_ = std::get<int>(row[1]);
-    length_ = std::get<int>(row[2]);
+    std::shared_ptr<state_type> state = std::make_shared<state_type>();
 
-    parts_ = db.parts(*this, verbly::part::index, -1).all();
+    state->id = columns.getInteger(0);
+    state->groupId = columns.getInteger(1);
+    state->length = columns.getInteger(2);
+
+    state->parts = db.parts(frame::id == state->id, verbly::part::index, -1).all();
+
+    state_ = std::move(state);
   }
 
 };
@@ -3,8 +3,11 @@
 
 #include <stdexcept>
 #include <list>
+#include <vector>
+#include <memory>
 #include <hkutil/database.h>
 #include "field.h"
+#include "connection.h"
 #include "filter.h"
 #include "part.h"
 
@@ -21,43 +24,53 @@ namespace verbly {
 
     // Construct from database
 
-    frame(const database& db, hatkirby::row row);
+    frame(const database& db, const cursor& columns);
 
     // Accessors
 
     bool isValid() const
     {
-      return valid_;
+      return (state_ != nullptr);
     }
 
     int getId() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized frame");
       }
 
-      return id_;
+      return state_->id;
+    }
+
+    int getGroupId() const
+    {
+      if (!state_)
+      {
+        throw std::domain_error("Bad access to uninitialized frame");
+      }
+
+      return state_->groupId;
     }
 
     int getLength() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized frame");
       }
 
-      return length_;
+      return state_->length;
     }
 
     const std::vector<part>& getParts() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized frame");
       }
 
-      return parts_;
+      return state_->parts;
     }
 
     // Type info
@@ -74,22 +87,22 @@ namespace verbly {
 
     operator filter() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized frame");
       }
 
-      return (id == id_);
+      return (id == state_->id);
     }
 
     filter operator!() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized frame");
       }
 
-      return (id != id_);
+      return (id != state_->id);
     }
 
     // Relationships to other objects
@@ -101,11 +114,16 @@ namespace verbly {
 
   private:
 
-    bool valid_ = false;
-    int id_;
-    int groupId_;
-    int length_;
-    std::vector<part> parts_;
+    // A frame is a handle to immutable state that is shared between copies, so
+    // copying a frame does not copy its parts.
+    struct state_type {
+      int id;
+      int groupId;
+      int length;
+      std::vector<part> parts;
+    };
+
+    std::shared_ptr<const state_type> state_;
   };
 
 };
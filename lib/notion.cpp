@@ -58,21 +58,21 @@ namespace verbly {
   const field notion::preposition_group_field::isA = field::joinField(object::notion, "notion_id", "is_a");
   const field notion::preposition_group_field::groupNameField = field::stringField("is_a", "groupname");
 
-  notion::notion(const database& db, hatkirby::row row) : valid_(true)
+  notion::notion(const database& db, const cursor& columns) : valid_(true)
   {
-    id_ = std::get<int>(row[0]);
-    partOfSpeech_ = static_cast<part_of_speech>(std::get<int>(row[1]));
+    id_ = columns.getInteger(0);
+    partOfSpeech_ = static_cast<part_of_speech>(columns.getInteger(1));
 
-    if (!std::holds_alternative<std::nullptr_t>(row[2]))
+    if (!columns.isNull(2))
     {
       hasWnid_ = true;
-      wnid_ = std::get<int>(row[2]);
+      wnid_ = columns.getInteger(2);
     }
 
-    if (!std::holds_alternative<std::nullptr_t>(row[3]))
+    if (!columns.isNull(3))
     {
       hasNumOfImages_ = true;
-      numOfImages_ = std::get<int>(row[3]);
+      numOfImages_ = columns.getInteger(3);
     }
   }
 
@@ -5,6 +5,7 @@
 #include <string>
 #include <hkutil/database.h>
 #include "field.h"
+#include "connection.h"
 #include "filter.h"
 
 namespace verbly {
@@ -20,7 +21,7 @@ namespace verbly {
 
     // Construct from database
 
-    notion(const database& db, hatkirby::row row);
+    notion(const database& db, const cursor& columns);
 
     // Accessors
 
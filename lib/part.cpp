@@ -7,7 +7,7 @@ namespace verbly {
 
   const object part::objectType = object::part;
 
-  const std::list<std::string> part::select = {"part_id", "frame_id", "part_index", "type", "role", "prepositions", "preposition_literality", "literal_value"};
+  const std::list<std::string> part::select = {"part_id", "frame_id", "part_index", "type", "role", "prepositions", "preposition_literality", "literal_value", "selrestrs", "synrestrs"};
 
   const field part::index = field::integerField(object::part, "part_index");
   const field part::type = field::integerField(object::part, "type");
@@ -27,8 +27,8 @@ namespace verbly {
 
   part part::createNounPhrase(
     std::string role,
-    std::set<std::string> selrestrs,
-    std::set<std::string> synrestrs)
+    restriction_set selrestrs,
+    restriction_set synrestrs)
   {
     return part {
       part_type::noun_phrase,
@@ -74,20 +74,18 @@ namespace verbly {
     };
   }
 
-  part::part(const database& db, hatkirby::row row)
+  part::part(const database&, const cursor& columns)
   {
-    int id = std::get<int>(row[0]);
-
-    type_ = static_cast<part_type>(std::get<int>(row[3]));
+    type_ = static_cast<part_type>(columns.getInteger(3));
 
     switch (type_)
     {
       case part_type::noun_phrase:
       {
         variant_ = np_type {
-          std::get<std::string>(row[4]),
-          db.selrestrs(id),
-          db.synrestrs(id)
+          columns.getString(4),
+          deserializeRestrictions(columns.getBlob(8)),
+          deserializeRestrictions(columns.getBlob(9))
         };
 
         break;
@@ -95,8 +93,7 @@ namespace verbly {
 
       case part_type::preposition:
       {
-        hatkirby::blob_type raw =
-          std::get<hatkirby::blob_type>(row[5]);
+        hatkirby::blob_type raw = columns.getBlob(5);
 
         std::string serializedChoices(
           std::begin(raw),
@@ -106,7 +103,7 @@ namespace verbly {
           hatkirby::split<std::vector<std::string>>(
             std::move(serializedChoices),
             ","),
-          (std::get<int>(row[6]) == 1)
+          columns.getBoolean(6)
         };
 
         break;
@@ -114,7 +111,7 @@ namespace verbly {
 
       case part_type::literal:
       {
-        variant_ = std::get<std::string>(row[7]);
+        variant_ = columns.getString(7);
 
         break;
       }
@@ -139,7 +136,7 @@ namespace verbly {
     return std::get<np_type>(variant_).role;
   }
 
-  const std::set<std::string>& part::getNounSelrestrs() const
+  restriction_set part::getNounSelrestrs() const
   {
     if (type_ != part_type::noun_phrase)
     {
@@ -149,7 +146,7 @@ namespace verbly {
     return std::get<np_type>(variant_).selrestrs;
   }
 
-  const std::set<std::string>& part::getNounSynrestrs() const
+  restriction_set part::getNounSynrestrs() const
   {
     if (type_ != part_type::noun_phrase)
     {
@@ -159,14 +156,14 @@ namespace verbly {
     return std::get<np_type>(variant_).synrestrs;
   }
 
-  bool part::nounHasSynrestr(std::string synrestr) const
+  bool part::nounHasSynrestr(restriction_set synrestr) const
   {
     if (type_ != part_type::noun_phrase)
     {
       throw std::domain_error("part is not a noun phrase");
     }
 
-    return std::get<np_type>(variant_).synrestrs.count(synrestr);
+    return (std::get<np_type>(variant_).synrestrs & synrestr).any();
   }
 
   const std::vector<std::string>& part::getPrepositionChoices() const
@@ -3,13 +3,14 @@
 
 #include <string>
 #include <vector>
-#include <set>
 #include <list>
 #include <hkutil/database.h>
 #include <variant>
 #include "field.h"
+#include "connection.h"
 #include "filter.h"
 #include "enums.h"
+#include "restriction.h"
 
 namespace verbly {
 
@@ -22,8 +23,8 @@ namespace verbly {
 
     static part createNounPhrase(
       std::string role,
-      std::set<std::string> selrestrs,
-      std::set<std::string> synrestrs);
+      restriction_set selrestrs,
+      restriction_set synrestrs);
 
     static part createVerb();
 
@@ -39,7 +40,7 @@ namespace verbly {
 
     // Construct from database
 
-    part(const database& db, hatkirby::row row);
+    part(const database& db, const cursor& columns);
 
     // General accessors
 
@@ -52,11 +53,11 @@ namespace verbly {
 
     const std::string& getNounRole() const;
 
-    const std::set<std::string>& getNounSelrestrs() const;
+    restriction_set getNounSelrestrs() const;
 
-    const std::set<std::string>& getNounSynrestrs() const;
+    restriction_set getNounSynrestrs() const;
 
-    bool nounHasSynrestr(std::string synrestr) const;
+    bool nounHasSynrestr(restriction_set synrestr) const;
 
     // Preposition accessors
 
@@ -119,8 +120,8 @@ namespace verbly {
 
     struct np_type {
       std::string role;
-      std::set<std::string> selrestrs;
-      std::set<std::string> synrestrs;
+      restriction_set selrestrs;
+      restriction_set synrestrs;
     };
 
     struct prep_type {
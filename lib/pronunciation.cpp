@@ -23,25 +23,25 @@ namespace verbly {
 
   pronunciation::pronunciation(
     const database& db,
-    hatkirby::row row) :
+    const cursor& columns) :
       valid_(true)
   {
-    id_ = std::get<int>(row[0]);
+    id_ = columns.getInteger(0);
 
     phonemes_ =
       hatkirby::split<std::vector<std::string>>(
-        std::get<std::string>(row[1]),
+        columns.getString(1),
         " ");
 
-    syllables_ = std::get<int>(row[2]);
-    stress_ = std::get<std::string>(row[3]);
+    syllables_ = columns.getInteger(2);
+    stress_ = columns.getString(3);
 
-    if (!std::holds_alternative<std::nullptr_t>(row[5]))
+    if (!columns.isNull(5))
     {
       hasRhyme_ = true;
 
-      prerhyme_ = std::get<std::string>(row[4]);
-      rhyme_ = std::get<std::string>(row[5]);
+      prerhyme_ = columns.getString(4);
+      rhyme_ = columns.getString(5);
     }
   }
 
@@ -6,6 +6,7 @@
 #include <string>
 #include <hkutil/database.h>
 #include "field.h"
+#include "connection.h"
 #include "filter.h"
 
 namespace verbly {
@@ -23,7 +24,7 @@ namespace verbly {
 
     // Construct from database
 
-    pronunciation(const database& db, hatkirby::row row);
+    pronunciation(const database& db, const cursor& columns);
 
     // Accessors
 
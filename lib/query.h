@@ -5,35 +5,32 @@
 #include <stdexcept>
 #include <string>
 #include <list>
+#include <optional>
+#include <set>
+#include <type_traits>
 #include <hkutil/database.h>
+#include "connection.h"
 #include "statement.h"
 #include "order.h"
+#include "bitmap_index.h"
+#include "word.h"
 
 namespace verbly {
 
-  class database_error : public std::logic_error {
-  public:
-
-    database_error(
-      std::string msg,
-      std::string sqlMsg) :
-        std::logic_error(msg + " (" + sqlMsg + ")")
-    {
-    }
-  };
-
   template <typename Object>
   class query {
   public:
 
     query(
       const database& db,
-      hatkirby::database& ppdb,
+      const connection& conn,
       filter queryFilter,
       order sortOrder,
-      int limit) :
+      int limit,
+      const statistics* stats = nullptr,
+      const bitmap_index* index = nullptr) :
         db_(db),
-        ppdb_(ppdb)
+        conn_(conn)
     {
       if ((sortOrder.getType() == order::type::field)
         && (sortOrder.getSortField().getObject() != Object::objectType))
@@ -42,7 +39,22 @@ namespace verbly {
           "Can only sort query by a field in the result table");
       }
 
-      statement stmt(Object::objectType, std::move(queryFilter));
+      // A randomly ordered query that can be answered entirely by the bitmap
+      // index is replaced by a query for a random sample of its IDs.
+      if (index
+        && !index->empty()
+        && (sortOrder.getType() == order::type::random))
+      {
+        std::optional<filter> sampled =
+          index->sample(Object::objectType, queryFilter, limit);
+
+        if (sampled)
+        {
+          queryFilter = std::move(*sampled);
+        }
+      }
+
+      statement stmt(Object::objectType, std::move(queryFilter), stats);
 
       queryString_ =
         stmt.getQueryString(Object::select, std::move(sortOrder), limit);
@@ -50,33 +62,73 @@ namespace verbly {
       bindings_ = stmt.getBindings();
     }
 
+    /**
+     * Requests that the given inflections of every word in the result be
+     * loaded along with the words, instead of with a separate query for each
+     * word the first time the inflection is accessed.
+     */
+    query& withInflections(std::set<inflection> categories)
+    {
+      static_assert(std::is_same<Object, word>::value,
+        "Only word queries can prefetch inflections");
+
+      inflections_ = std::move(categories);
+
+      return *this;
+    }
+
     std::vector<Object> all() const
     {
-      std::vector<hatkirby::row> rows =
-        ppdb_.queryAll(queryString_, bindings_);
+      cursor rows = conn_.query(queryString_, bindings_);
 
       std::vector<Object> result;
 
-      for (hatkirby::row& r : rows)
+      while (rows.next())
       {
-        result.emplace_back(db_, std::move(r));
+        result.emplace_back(db_, rows);
       }
 
+      prefetch(result);
+
       return result;
     }
 
     Object first() const
     {
-      return { db_, ppdb_.queryFirst(queryString_, bindings_) };
+      cursor rows = conn_.query(queryString_, bindings_);
+
+      if (!rows.next())
+      {
+        throw std::logic_error("Query returned empty dataset");
+      }
+
+      std::vector<Object> result;
+      result.emplace_back(db_, rows);
+
+      prefetch(result);
+
+      return std::move(result.front());
     }
 
   private:
 
     const database& db_;
-    hatkirby::database& ppdb_;
+    const connection& conn_;
+
+    void prefetch(std::vector<Object>& result) const
+    {
+      if constexpr (std::is_same<Object, word>::value)
+      {
+        if (!inflections_.empty())
+        {
+          word::prefetchInflections(db_, result, inflections_);
+        }
+      }
+    }
 
     std::string queryString_;
     std::list<hatkirby::binding> bindings_;
+    std::set<inflection> inflections_;
   };
 
 };
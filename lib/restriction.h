@@ -0,0 +1,47 @@
+#ifndef RESTRICTION_H_5E0B7A93
+#define RESTRICTION_H_5E0B7A93
+
+#include <bitset>
+#include <hkutil/database.h>
+
+namespace verbly {
+
+  /**
+   * A set of selectional or syntactic restrictions. The generator interns the
+   * name of each distinct restriction as a bit, so a set of restrictions is a
+   * bitmask and testing for a restriction is a single AND. Bits are only
+   * meaningful within the datafile they were read from; use
+   * database::selrestr() and database::synrestr() to look them up by name.
+   */
+  using restriction_set = std::bitset<64>;
+
+  // Restriction sets are stored in the datafile as eight little-endian bytes.
+
+  inline hatkirby::blob_type serializeRestrictions(restriction_set arg)
+  {
+    unsigned long long mask = arg.to_ullong();
+    hatkirby::blob_type result;
+
+    for (int i = 0; i < 8; i++)
+    {
+      result.push_back(static_cast<unsigned char>((mask >> (i * 8)) & 0xFF));
+    }
+
+    return result;
+  }
+
+  inline restriction_set deserializeRestrictions(const hatkirby::blob_type& arg)
+  {
+    unsigned long long mask = 0;
+
+    for (size_t i = 0; (i < arg.size()) && (i < 8); i++)
+    {
+      mask |= static_cast<unsigned long long>(arg[i]) << (i * 8);
+    }
+
+    return restriction_set(mask);
+  }
+
+};
+
+#endif /* end of include guard: RESTRICTION_H_5E0B7A93 */
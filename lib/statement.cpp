@@ -1,6 +1,9 @@
 #include "statement.h"
 #include <sstream>
 #include <utility>
+#include <vector>
+#include <algorithm>
+#include <cmath>
 #include <hkutil/string.h>
 #include "filter.h"
 #include "order.h"
@@ -9,8 +12,16 @@ namespace verbly {
 
   statement::statement(
     object context,
-    filter queryFilter) :
-      statement(context, getTableForContext(context), queryFilter.compact().normalize(context))
+    filter queryFilter,
+    const statistics* stats) :
+      statement(
+        context,
+        getTableForContext(context),
+        queryFilter.compact().normalize(context),
+        0,
+        0,
+        {},
+        stats)
   {
   }
 
@@ -98,10 +109,9 @@ namespace verbly {
       queryStream << topCondition_.flatten().toSql(true, debug);
     }
 
-    queryStream << " GROUP BY ";
-    queryStream << topTable_;
-    queryStream << ".";
-    queryStream << select.front();
+    // No GROUP BY is necessary: relationships are tested with IN
+    // subqueries, and the only joins left in the main statement are against
+    // hierarchal CTEs, which contain at most one row per id.
 
     queryStream << " ORDER BY ";
 
@@ -158,10 +168,14 @@ namespace verbly {
     std::string tableName,
     filter clause,
     int nextTableId,
-    int nextWithId) :
+    int nextWithId,
+    std::unordered_map<filter, std::string> withNames,
+    const statistics* stats) :
       context_(context),
       nextTableId_(nextTableId),
       nextWithId_(nextWithId),
+      withNames_(std::move(withNames)),
+      stats_(stats),
       topTable_(instantiateTable(std::move(tableName))),
       topCondition_(parseFilter(std::move(clause)))
   {
@@ -384,88 +398,49 @@ namespace verbly {
               joinCondition &= (field::integerField(joinTableName.c_str(), clause.getField().getConditionColumn()) == clause.getField().getConditionValue());
             }
 
-            // Instantiate a CTE in case we need one. This is necessary because
-            // the nextWithId is propagated in the instantiation of the joinStmt
-            // below.
-            std::string withName = instantiateWith(joinTableName);
-
             // Recursively parse the subquery, and therefore obtain an
-            // instantiated table to join against, as well as any joins or CTEs
+            // instantiated table to test against, as well as any joins or CTEs
             // that the subquery may require to function.
             statement joinStmt(
               joinContext,
               joinTableName,
               std::move(joinCondition).normalize(clause.getField().getJoinObject()),
               nextTableId_,
-              nextWithId_);
+              nextWithId_,
+              withNames_,
+              stats_);
 
             std::string joinTable = joinStmt.topTable_;
 
-            if (clause.getComparison() == filter::comparison::does_not_match)
-            {
-              // If the comparison is actually a negative filter, we can't just
-              // integrate the subquery statement into this statement and then
-              // join against it. Even if we LEFT JOIN against the subquery's
-              // top level table and then condition on the join column being
-              // NULL, if that table joins against any other table, the query
-              // will return zero results. Instead, we create a non-recursive
-              // CTE that represents the subquery, then LEFT JOIN against it and
-              // condition on the join column being NULL as before.
-              std::string withInstName = instantiateTable(withName);
-
-              // LEFT JOIN against the CTE.
-              joins_.emplace_back(
-                true,
-                withName,
-                topTable_,
-                clause.getField().getColumn(),
-                withInstName,
-                clause.getField().getColumn());
-
-              // All CTEs have to be in the main statement, so integrate any
-              // CTEs that our subquery uses. Also, retrieve the table mapping,
-              // joins list, and subquery condition, and use them to create the
-              // CTE.
-              std::map<std::string, std::string> cteTables = std::move(joinStmt.tables_);
-              std::list<join> cteJoins = std::move(joinStmt.joins_);
-              condition cteCondition = integrate(std::move(joinStmt), true);
-
-              withs_.emplace_back(
-                std::move(withName),
-                clause.getField(),
-                std::move(cteTables),
-                std::move(joinTable),
-                std::move(cteCondition),
-                std::move(cteJoins),
-                false);
-
-              // Condition on the join column being NULL, which causes the query
-              // to only return results that do not match the subquery.
-              return condition(std::move(withInstName), clause.getField().getColumn(), true);
-            } else {
-              // INNER JOIN against the top table of the subquery.
-              joins_.emplace_back(
+            // We never select any columns from the joined table, so rather
+            // than joining against it (which multiplies the result rows by the
+            // number of matching rows, and would then require us to group them
+            // back together) we test whether the row's value is among those
+            // selected by a subquery. A negative filter is the same subquery
+            // tested for non-membership. All CTEs have to be in the main
+            // statement, so integrate any CTEs that our subquery uses, but
+            // keep its joins inside of the subquery.
+            std::list<join> existsJoins = std::move(joinStmt.joins_);
+            condition existsCondition = integrate(std::move(joinStmt), true);
+
+            return condition(
+              (clause.getComparison() == filter::comparison::does_not_match),
+              join(
                 false,
                 std::move(joinTableName),
                 topTable_,
                 clause.getField().getColumn(),
                 std::move(joinTable),
-                clause.getField().getColumn());
-
-              // Integrate the subquery's table mappings, joins, and CTEs into
-              // this statement, and return the subquery condition as our
-              // condition.
-              return integrate(std::move(joinStmt));
-            }
+                clause.getField().getColumn()),
+              std::move(existsJoins),
+              std::move(existsCondition));
           }
 
           case field::type::join_through:
           case field::type::join_through_where:
           {
-            // Instantiate a CTE in case we need one. This is necessary because
-            // the nextWithId is propagated in the instantiation of the joinStmt
-            // below.
-            std::string withName = instantiateWith(clause.getField().getTable());
+            // Instantiate the through table.
+            std::string throughTable = instantiateTable(clause.getField().getTable());
 
             // Recursively parse the subquery, and therefore obtain an
             // instantiated table to join against, as well as any joins or CTEs
@@ -475,123 +450,101 @@ namespace verbly {
               getTableForContext(clause.getField().getJoinObject()),
               clause.getJoinCondition().normalize(clause.getField().getJoinObject()),
               nextTableId_,
-              nextWithId_);
+              nextWithId_,
+              withNames_,
+              stats_);
+
+            // As above, the relationship is tested using a subquery. The
+            // through table is the top table of the subquery, and it joins
+            // against the top table of the recursively parsed statement, which
+            // is a one-to-one join.
+            std::list<join> existsJoins;
+            existsJoins.emplace_back(
+              false,
+              getTableForContext(clause.getField().getJoinObject()),
+              throughTable,
+              clause.getField().getForeignJoinColumn(),
+              joinStmt.topTable_,
+              clause.getField().getForeignColumn());
 
-            std::string joinTable = joinStmt.topTable_;
+            for (join& j : joinStmt.joins_)
+            {
+              existsJoins.push_back(std::move(j));
+            }
 
-            if (clause.getComparison() == filter::comparison::does_not_match)
+            condition existsCondition = integrate(std::move(joinStmt), true);
+
+            // If this is a condition join, add the condition.
+            if (clause.getField().getType() == field::type::join_through_where)
             {
-              // If the comparison is actually a negative filter, we can't just
-              // integrate the subquery statement into this statement and then
-              // join against it. Even if we LEFT JOIN against the subquery's
-              // through table and then condition on the join column being NULL,
-              // the query will return zero results because the through table
-              // joins against the subquery's top level table. Instead, we
-              // create a non-recursive CTE that represents the through table
-              // joined against the subquery, then LEFT JOIN against it and
-              // condition on the join column being NULL as before.
-              std::string withInstName = instantiateTable(withName);
-
-              // LEFT JOIN against the CTE.
-              joins_.emplace_back(
-                true,
-                withName,
-                topTable_,
-                clause.getField().getColumn(),
-                withInstName,
-                clause.getField().getJoinColumn());
+              existsCondition &=
+                condition(
+                  throughTable,
+                  clause.getField().getConditionColumn(),
+                  condition::comparison::equals,
+                  clause.getField().getConditionValue());
+            }
 
-              // Modify the substatement such that the through table is the top
-              // table, and such that it joins against the previous top table.
-              std::string throughTable = joinStmt.instantiateTable(clause.getField().getTable());
-              joinStmt.joins_.emplace_back(
+            return condition(
+              (clause.getComparison() == filter::comparison::does_not_match),
+              join(
                 false,
-                getTableForContext(clause.getField().getJoinObject()),
-                throughTable,
-                clause.getField().getForeignJoinColumn(),
-                std::move(joinTable),
-                clause.getField().getForeignColumn());
+                clause.getField().getTable(),
+                topTable_,
+                clause.getField().getColumn(),
+                std::move(throughTable),
+                clause.getField().getJoinColumn()),
+              std::move(existsJoins),
+              std::move(existsCondition));
+          }
 
-              joinStmt.topTable_ = throughTable;
+          case field::type::hierarchal_join:
+          {
+            filter withFilter(
+              clause.getField(),
+              filter::comparison::hierarchally_matches,
+              clause.getJoinCondition().normalize(clause.getField().getObject()));
+
+            // The contents of a CTE only depend on the field and the subquery
+            // it was generated from, so if an identical CTE has already been
+            // created anywhere in the query, we can reuse it.
+            std::string withName;
+            if (withNames_.count(withFilter))
+            {
+              withName = withNames_.at(withFilter);
+            } else {
+              withName = instantiateWith(clause.getField().getTable());
+
+              // Recursively parse the subquery in order to create the CTE.
+              statement withStmt(
+                clause.getField().getObject(),
+                getTableForContext(clause.getField().getObject()),
+                withFilter.getJoinCondition(),
+                nextTableId_,
+                nextWithId_,
+                withNames_,
+                stats_);
 
               // All CTEs have to be in the main statement, so integrate any
               // CTEs that our subquery uses. Also, retrieve the table mapping,
               // joins list, and subquery condition, and use them to create the
               // CTE.
-              std::map<std::string, std::string> cteTables = std::move(joinStmt.tables_);
-              std::list<join> cteJoins = std::move(joinStmt.joins_);
-              condition cteCondition = integrate(std::move(joinStmt), true);
-
-              // If this is a condition join, add the condition.
-              if (clause.getField().getType() == field::type::join_through_where)
-              {
-                cteCondition &=
-                  condition(
-                    throughTable,
-                    clause.getField().getConditionColumn(),
-                    condition::comparison::equals,
-                    clause.getField().getConditionValue());
-              }
+              std::string cteTopTable = std::move(withStmt.topTable_);
+              std::map<std::string, std::string> cteTables = std::move(withStmt.tables_);
+              std::list<join> cteJoins = std::move(withStmt.joins_);
+              condition cteCondition = integrate(std::move(withStmt), true);
 
               withs_.emplace_back(
-                std::move(withName),
+                withName,
                 clause.getField(),
                 std::move(cteTables),
-                std::move(throughTable),
+                std::move(cteTopTable),
                 std::move(cteCondition),
                 std::move(cteJoins),
-                false);
-
-              // Condition on the join column being NULL, which causes the query
-              // to only return results that do not match the subquery.
-              return condition(std::move(withInstName), clause.getField().getJoinColumn(), true);
-            } else {
-              // Instantiate the through table.
-              std::string throughTable = instantiateTable(clause.getField().getTable());
-
-              // INNER JOIN against the through table.
-              joins_.emplace_back(
-                false,
-                clause.getField().getTable(),
-                topTable_,
-                clause.getField().getColumn(),
-                throughTable,
-                clause.getField().getJoinColumn());
-
-              // INNER JOIN from the through table to the top table of the subquery.
-              joins_.emplace_back(
-                false,
-                getTableForContext(clause.getField().getJoinObject()),
-                throughTable,
-                clause.getField().getForeignJoinColumn(),
-                std::move(joinTable),
-                clause.getField().getForeignColumn());
-
-              // Integrate the subquery's table mappings, joins, and CTEs into
-              // this statement, and return the subquery condition as our
-              // condition.
-              condition resultCond = integrate(std::move(joinStmt));
+                true);
 
-              // If this is a condition join, add the condition.
-              if (clause.getField().getType() == field::type::join_through_where)
-              {
-                resultCond &=
-                  condition(
-                    throughTable,
-                    clause.getField().getConditionColumn(),
-                    condition::comparison::equals,
-                    clause.getField().getConditionValue());
-              }
-
-              return std::move(resultCond);
+              withNames_[std::move(withFilter)] = withName;
             }
-          }
-
-          case field::type::hierarchal_join:
-          {
-            // Create a recursive CTE that represents the results of the subquery.
-            std::string withName = instantiateWith(clause.getField().getTable());
-            std::string withInstName = instantiateTable(withName);
 
             // If we are matching against the subquery, we INNER JOIN with the
             // CTE. If we are negatively matching the subquery, we LEFT JOIN
@@ -602,39 +555,34 @@ namespace verbly {
               outer = true;
             }
 
-            // Join against the CTE.
-            joins_.emplace_back(
-              outer,
-              withName,
-              topTable_,
-              clause.getField().getColumn(),
-              withInstName,
-              clause.getField().getColumn());
-
-            // Recursively parse the subquery in order to create the CTE.
-            statement withStmt(
-              clause.getField().getObject(),
-              getTableForContext(clause.getField().getObject()),
-              clause.getJoinCondition().normalize(clause.getField().getObject()),
-              nextTableId_,
-              nextWithId_);
-
-            // All CTEs have to be in the main statement, so integrate any CTEs
-            // that our subquery uses. Also, retrieve the table mapping, joins
-            // list, and subquery condition, and use them to create the CTE.
-            std::string cteTopTable = std::move(withStmt.topTable_);
-            std::map<std::string, std::string> cteTables = std::move(withStmt.tables_);
-            std::list<join> cteJoins = std::move(withStmt.joins_);
-            condition cteCondition = integrate(std::move(withStmt), true);
-
-            withs_.emplace_back(
-              std::move(withName),
-              clause.getField(),
-              std::move(cteTables),
-              std::move(cteTopTable),
-              std::move(cteCondition),
-              std::move(cteJoins),
-              true);
+            // Join against the CTE, unless this statement already has the
+            // exact same join, in which case we can reuse its table.
+            std::string withInstName;
+            for (const join& j : joins_)
+            {
+              if ((j.isOuterJoin() == outer)
+                && (j.getForeignTableName() == withName)
+                && (j.getJoinTable() == topTable_)
+                && (j.getJoinColumn() == clause.getField().getColumn()))
+              {
+                withInstName = j.getForeignTable();
+
+                break;
+              }
+            }
+
+            if (withInstName.empty())
+            {
+              withInstName = instantiateTable(withName);
+
+              joins_.emplace_back(
+                outer,
+                withName,
+                topTable_,
+                clause.getField().getColumn(),
+                withInstName,
+                clause.getField().getColumn());
+            }
 
             // If we are matching against the subquery, no condition is
             // necessary. If we are negatively matching the subquery, we
@@ -665,6 +613,9 @@ namespace verbly {
         if (grp.getChildren().empty())
         {
           grp = {};
+        } else if (stats_)
+        {
+          grp.reorder(*stats_, tables_);
         }
 
         return grp;
@@ -702,12 +653,14 @@ namespace verbly {
    * this statement. This is used because filters are recursive objects, but
    * statements need to be flat to be compiled into a SQL query. Thus, all CTEs
    * have to be in the main statement, and all table mappings & joins that
-   * aren't part of a CTE have to be in the main statement as well. Finally, we
-   * need to copy up the next ID fields in order to properly prevent ID reuse.
+   * aren't part of a CTE or an IN subquery have to be in the main statement
+   * as well. Finally, we need to copy up the next ID fields in order to
+   * properly prevent ID reuse, along with the registry of CTEs that have
+   * already been created.
    */
-  statement::condition statement::integrate(statement subStmt, bool cte)
+  statement::condition statement::integrate(statement subStmt, bool subquery)
   {
-    if (!cte)
+    if (!subquery)
     {
       for (auto& mapping : subStmt.tables_)
       {
@@ -727,6 +680,7 @@ namespace verbly {
 
     nextTableId_ = subStmt.nextTableId_;
     nextWithId_ = subStmt.nextWithId_;
+    withNames_ = std::move(subStmt.withNames_);
 
     return subStmt.topCondition_.resolveCompareFields(context_, topTable_);
   }
@@ -974,6 +928,69 @@ namespace verbly {
 
         break;
       }
+
+      case type::exists:
+      {
+        const exists_type& exists = std::get<exists_type>(variant_);
+
+        // The relationship is tested with an uncorrelated IN subquery rather
+        // than a correlated EXISTS subquery. SQLite evaluates the subquery
+        // once, and can use its result to look up matching rows of the outer
+        // table, instead of scanning the outer table and running the subquery
+        // again for each of its rows.
+        std::string outerColumn =
+          exists.from.getJoinTable() + "." + exists.from.getJoinColumn();
+
+        std::string innerColumn =
+          exists.from.getForeignTable() + "." + exists.from.getForeignColumn();
+
+        std::list<std::string> clauses;
+
+        if (exists.negated)
+        {
+          // NOT IN is null rather than true when the outer column is null, or
+          // when there is no match but the subquery returns a null.
+          sql << "(" << outerColumn << " IS NULL OR ";
+          sql << outerColumn << " NOT IN ";
+
+          clauses.push_back(innerColumn + " IS NOT NULL");
+        } else {
+          sql << outerColumn << " IN ";
+        }
+
+        if (exists.where->getType() != type::empty)
+        {
+          clauses.push_back(exists.where->flatten().toSql(false, debug));
+        }
+
+        sql << "(SELECT " << innerColumn << " FROM ";
+        sql << exists.from.getForeignTableName();
+        sql << " AS ";
+        sql << exists.from.getForeignTable();
+
+        for (const join& j : exists.joins)
+        {
+          sql << " " << j;
+        }
+
+        if (!clauses.empty())
+        {
+          sql << " WHERE ";
+          sql << hatkirby::implode(
+            std::begin(clauses),
+            std::end(clauses),
+            " AND ");
+        }
+
+        sql << ")";
+
+        if (exists.negated)
+        {
+          sql << ")";
+        }
+
+        break;
+      }
     }
 
     return sql.str();
@@ -1018,6 +1035,11 @@ namespace verbly {
 
         return bindings;
       }
+
+      case type::exists:
+      {
+        return std::get<exists_type>(variant_).where->flattenBindings();
+      }
     }
   }
 
@@ -1053,6 +1075,7 @@ namespace verbly {
       }
 
       case type::singleton:
+      case type::exists:
       {
         condition grp(false);
         grp += *this;
@@ -1065,7 +1088,16 @@ namespace verbly {
 
       case type::group:
       {
-        *this += std::move(n);
+        if (std::get<group_type>(variant_).orlogic)
+        {
+          condition grp(false);
+          grp += *this;
+          grp += std::move(n);
+
+          *this = grp;
+        } else {
+          *this += std::move(n);
+        }
 
         break;
       }
@@ -1074,6 +1106,21 @@ namespace verbly {
     return *this;
   }
 
+  statement::condition::condition(
+    bool negated,
+    join from,
+    std::list<join> joins,
+    condition where) :
+      type_(type::exists),
+      variant_(exists_type {
+        negated,
+        std::move(from),
+        std::move(joins),
+        new condition(std::move(where))
+      })
+  {
+  }
+
   const std::list<statement::condition>& statement::condition::getChildren()
     const
   {
@@ -1128,6 +1175,18 @@ namespace verbly {
 
         return result;
       }
+
+      case type::exists:
+      {
+        const exists_type& exists = std::get<exists_type>(variant_);
+
+        return {
+          exists.negated,
+          exists.from,
+          exists.joins,
+          exists.where->flatten()
+        };
+      }
     }
   }
 
@@ -1175,6 +1234,245 @@ namespace verbly {
 
         return result;
       }
+
+      case type::exists:
+      {
+        const exists_type& exists = std::get<exists_type>(variant_);
+
+        return {
+          exists.negated,
+          exists.from,
+          exists.joins,
+          exists.where->resolveCompareFields(context, tableName)
+        };
+      }
+    }
+  }
+
+
+  /**
+   * This method estimates the fraction of rows for which the condition holds.
+   * The table mapping is used to find the underlying table of an instantiated
+   * table, and the statistics are used to estimate how many rows share a value
+   * of a column. When no statistics are available for a column, the estimates
+   * fall back on fixed guesses similar to the ones SQLite makes.
+   */
+  double statement::condition::estimateSelectivity(
+    const statistics& stats,
+    const std::map<std::string, std::string>& tables) const
+  {
+    switch (type_)
+    {
+      case type::empty:
+      {
+        return 1.0;
+      }
+
+      case type::singleton:
+      {
+        const singleton_type& singleton = std::get<singleton_type>(variant_);
+
+        std::string tableName = singleton.table;
+        if (tables.count(tableName))
+        {
+          tableName = tables.at(tableName);
+        }
+
+        double rowCount = stats.getRowCount(tableName);
+        double rowsPerValue = stats.getRowsPerValue(tableName, singleton.column);
+
+        double equalSelectivity = 0.1;
+        if ((rowCount > 0) && (rowsPerValue > 0))
+        {
+          equalSelectivity = rowsPerValue / rowCount;
+        }
+
+        switch (singleton.cmp)
+        {
+          case comparison::equals:
+          {
+            return equalSelectivity;
+          }
+
+          case comparison::does_not_equal:
+          {
+            return 1.0 - equalSelectivity;
+          }
+
+          case comparison::is_greater_than:
+          case comparison::is_at_most:
+          case comparison::is_less_than:
+          case comparison::is_at_least:
+          case comparison::is_like:
+          {
+            return 0.25;
+          }
+
+          case comparison::is_not_like:
+          {
+            return 0.75;
+          }
+
+          case comparison::is_not_null:
+          case comparison::is_null:
+          {
+            return 0.5;
+          }
+        }
+
+        throw std::logic_error("Invalid comparison type");
+      }
+
+      case type::group:
+      {
+        const group_type& group = std::get<group_type>(variant_);
+
+        // Assume that the children are independent.
+        double result = 1.0;
+        for (const condition& cond : group.children)
+        {
+          if (group.orlogic)
+          {
+            result *= 1.0 - cond.estimateSelectivity(stats, tables);
+          } else {
+            result *= cond.estimateSelectivity(stats, tables);
+          }
+        }
+
+        if (group.orlogic)
+        {
+          return 1.0 - result;
+        } else {
+          return result;
+        }
+      }
+
+      case type::exists:
+      {
+        const exists_type& exists = std::get<exists_type>(variant_);
+
+        // The tables in the subquery aren't part of the statement's table
+        // mapping, but the joins name them.
+        std::map<std::string, std::string> subTables = tables;
+        subTables[exists.from.getForeignTable()] =
+          exists.from.getForeignTableName();
+
+        for (const join& j : exists.joins)
+        {
+          subTables[j.getForeignTable()] = j.getForeignTableName();
+        }
+
+        double rowSelectivity =
+          exists.where->estimateSelectivity(stats, subTables);
+
+        // A row satisfies the subquery if any of its related rows match.
+        double fanOut =
+          stats.getRowsPerValue(
+            exists.from.getForeignTableName(),
+            exists.from.getForeignColumn());
+
+        if (fanOut < 1.0)
+        {
+          fanOut = 1.0;
+        }
+
+        double result = 1.0 - std::pow(1.0 - rowSelectivity, fanOut);
+
+        if (exists.negated)
+        {
+          return 1.0 - result;
+        } else {
+          return result;
+        }
+      }
+    }
+
+    throw std::logic_error("Invalid condition type");
+  }
+
+  /**
+   * This method estimates the relative cost of evaluating the condition once,
+   * in units of single column comparisons.
+   */
+  double statement::condition::estimateCost() const
+  {
+    switch (type_)
+    {
+      case type::empty:
+      {
+        return 0.0;
+      }
+
+      case type::singleton:
+      {
+        return 1.0;
+      }
+
+      case type::group:
+      {
+        const group_type& group = std::get<group_type>(variant_);
+
+        double result = 0.0;
+        for (const condition& cond : group.children)
+        {
+          result += cond.estimateCost();
+        }
+
+        return result;
+      }
+
+      case type::exists:
+      {
+        const exists_type& exists = std::get<exists_type>(variant_);
+
+        // Each table in the subquery costs at least one index lookup.
+        return (4.0 * (exists.joins.size() + 1)) + exists.where->estimateCost();
+      }
+    }
+
+    throw std::logic_error("Invalid condition type");
+  }
+
+  /**
+   * This method sorts the children of a group so that the conditions that are
+   * cheapest to evaluate and most likely to decide the group come first. SQLite
+   * stops evaluating an AND as soon as one term is false, and an OR as soon as
+   * one term is true, so each child is ranked by the chance that it short
+   * circuits the group divided by its cost. Ties keep their original order.
+   */
+  void statement::condition::reorder(
+    const statistics& stats,
+    const std::map<std::string, std::string>& tables)
+  {
+    if (type_ != type::group)
+    {
+      return;
+    }
+
+    group_type& group = std::get<group_type>(variant_);
+
+    std::vector<std::tuple<double, condition>> ranked;
+    for (condition& cond : group.children)
+    {
+      double selectivity = cond.estimateSelectivity(stats, tables);
+      double decisiveness = group.orlogic ? selectivity : (1.0 - selectivity);
+      double rank = decisiveness / std::max(cond.estimateCost(), 1.0);
+
+      ranked.emplace_back(rank, std::move(cond));
+    }
+
+    std::stable_sort(
+      std::begin(ranked),
+      std::end(ranked),
+      [] (const auto& left, const auto& right) {
+        return std::get<0>(left) > std::get<0>(right);
+      });
+
+    group.children.clear();
+
+    for (auto& rankedCond : ranked)
+    {
+      group.children.push_back(std::move(std::get<1>(rankedCond)));
     }
   }
 
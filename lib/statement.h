@@ -4,11 +4,14 @@
 #include <string>
 #include <list>
 #include <map>
+#include <unordered_map>
 #include <hkutil/database.h>
+#include <hkutil/recptr.h>
 #include <variant>
 #include "enums.h"
 #include "field.h"
 #include "filter.h"
+#include "statistics.h"
 
 namespace verbly {
 
@@ -28,7 +31,10 @@ namespace verbly {
   class statement {
   public:
 
-    statement(object context, filter queryFilter);
+    statement(
+      object context,
+      filter queryFilter,
+      const statistics* stats = nullptr);
 
     std::string getQueryString(
       std::list<std::string> select,
@@ -106,7 +112,8 @@ namespace verbly {
       enum class type {
         empty,
         singleton,
-        group
+        group,
+        exists
       };
 
       enum class comparison {
@@ -157,6 +164,14 @@ namespace verbly {
 
       const std::list<condition>& getChildren() const;
 
+      // Exists
+
+      condition(
+        bool negated,
+        join from,
+        std::list<join> joins,
+        condition where);
+
       // Utility
 
       std::string toSql(bool toplevel, bool debug = false) const;
@@ -169,6 +184,18 @@ namespace verbly {
         object context,
         std::string tableName) const;
 
+      // Planning
+
+      double estimateSelectivity(
+        const statistics& stats,
+        const std::map<std::string, std::string>& tables) const;
+
+      double estimateCost() const;
+
+      void reorder(
+        const statistics& stats,
+        const std::map<std::string, std::string>& tables);
+
     private:
 
       struct singleton_type {
@@ -184,11 +211,19 @@ namespace verbly {
         bool orlogic;
       };
 
+      struct exists_type {
+        bool negated;
+        join from;
+        std::list<join> joins;
+        hatkirby::recptr<condition> where;
+      };
+
       using variant_type =
         std::variant<
           std::monostate,
           singleton_type,
-          group_type>;
+          group_type,
+          exists_type>;
 
       variant_type variant_;
 
@@ -275,7 +310,14 @@ namespace verbly {
 
     static const std::list<field> getSelectForContext(object context);
 
-    statement(object context, std::string tableName, filter clause, int nextTableId = 0, int nextWithId = 0);
+    statement(
+      object context,
+      std::string tableName,
+      filter clause,
+      int nextTableId = 0,
+      int nextWithId = 0,
+      std::unordered_map<filter, std::string> withNames = {},
+      const statistics* stats = nullptr);
 
     condition parseFilter(filter queryFilter);
 
@@ -283,11 +325,19 @@ namespace verbly {
 
     std::string instantiateWith(std::string name);
 
-    condition integrate(statement subStmt, bool cte = false);
+    condition integrate(statement subStmt, bool subquery = false);
 
     int nextTableId_;
     int nextWithId_;
 
+    // Maps the filter that a CTE was generated from to the CTE's identifier,
+    // so that identical subqueries are only emitted once per query.
+    std::unordered_map<filter, std::string> withNames_;
+
+    // If this is set, the children of each condition group are sorted so that
+    // the conditions most likely to decide the group are evaluated first.
+    const statistics* stats_;
+
     object context_;
     std::map<std::string, std::string> tables_;
     std::string topTable_;
@@ -0,0 +1,103 @@
+#include "statistics.h"
+#include <sstream>
+
+namespace verbly {
+
+  statistics::statistics(hatkirby::database& db)
+  {
+    // Datafiles that were not analyzed have no statistics table.
+    std::vector<hatkirby::row> tables =
+      db.queryAll(
+        "SELECT name FROM sqlite_master WHERE type = 'table' AND name = ?",
+        { std::string("sqlite_stat1") });
+
+    if (tables.empty())
+    {
+      return;
+    }
+
+    std::vector<hatkirby::row> rows =
+      db.queryAll("SELECT tbl, idx, stat FROM sqlite_stat1");
+
+    for (hatkirby::row& r : rows)
+    {
+      if (!std::holds_alternative<std::string>(r[2]))
+      {
+        continue;
+      }
+
+      std::string table = std::get<std::string>(r[0]);
+
+      // The first number in the stat column is the number of rows in the
+      // table, and the second is the average number of rows that share a
+      // value of the index's leftmost column.
+      std::istringstream stat(std::get<std::string>(r[2]));
+
+      double rowCount = 0;
+      double rowsPerValue = 0;
+      stat >> rowCount >> rowsPerValue;
+
+      rowCounts_[table] = rowCount;
+
+      if (!std::holds_alternative<std::string>(r[1]) || !rowsPerValue)
+      {
+        continue;
+      }
+
+      std::vector<hatkirby::row> columns =
+        db.queryAll(
+          "SELECT name FROM pragma_index_info(?) ORDER BY seqno",
+          { std::get<std::string>(r[1]) });
+
+      if (!columns.empty()
+        && std::holds_alternative<std::string>(columns.front()[0]))
+      {
+        rowsPerValue_[std::make_tuple(
+          std::move(table),
+          std::get<std::string>(columns.front()[0]))] = rowsPerValue;
+      }
+    }
+
+    // Rowid primary keys are not listed as indexes, but each value of one
+    // identifies exactly one row.
+    for (const auto& mapping : rowCounts_)
+    {
+      std::vector<hatkirby::row> keys =
+        db.queryAll(
+          "SELECT name FROM pragma_table_info(?) WHERE pk = 1",
+          { mapping.first });
+
+      for (hatkirby::row& key : keys)
+      {
+        rowsPerValue_[std::make_tuple(
+          mapping.first,
+          std::get<std::string>(key[0]))] = 1;
+      }
+    }
+  }
+
+  double statistics::getRowCount(const std::string& table) const
+  {
+    if (!rowCounts_.count(table))
+    {
+      return 0;
+    }
+
+    return rowCounts_.at(table);
+  }
+
+  double statistics::getRowsPerValue(
+    const std::string& table,
+    const std::string& column) const
+  {
+    auto key = std::make_tuple(table, column);
+
+    if (!rowsPerValue_.count(key))
+    {
+      return 0;
+    }
+
+    return rowsPerValue_.at(key);
+  }
+
+};
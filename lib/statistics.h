@@ -0,0 +1,52 @@
+#ifndef STATISTICS_H_6A1E4C27
+#define STATISTICS_H_6A1E4C27
+
+#include <string>
+#include <map>
+#include <tuple>
+#include <hkutil/database.h>
+
+namespace verbly {
+
+  /**
+   * Table and index statistics gathered by ANALYZE, which the statement
+   * compiler can use to estimate how selective a condition is. A default
+   * constructed object contains no statistics, and all of its estimates are
+   * unknown.
+   */
+  class statistics {
+  public:
+
+    // Constructors
+
+    statistics() = default;
+
+    explicit statistics(hatkirby::database& db);
+
+    // Accessors
+
+    bool empty() const
+    {
+      return rowCounts_.empty();
+    }
+
+    // Returns the number of rows in the given table, or zero if it is not
+    // known.
+    double getRowCount(const std::string& table) const;
+
+    // Returns the average number of rows in the given table that share a
+    // single value of the given column, or zero if it is not known.
+    double getRowsPerValue(
+      const std::string& table,
+      const std::string& column) const;
+
+  private:
+
+    std::map<std::string, double> rowCounts_;
+    std::map<std::tuple<std::string, std::string>, double> rowsPerValue_;
+
+  };
+
+};
+
+#endif /* end of include guard: STATISTICS_H_6A1E4C27 */
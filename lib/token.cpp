@@ -1,7 +1,6 @@
 #include "token.h"
 #include <stdexcept>
 #include <algorithm>
-#include <hkutil/string.h>
 
 namespace verbly {
 
@@ -44,116 +43,161 @@ namespace verbly {
 
   std::string token::compile() const
   {
-    return compileHelper(" ", false, casing::normal);
+    std::string result;
+    compile(result);
+
+    return result;
   }
 
-  std::string token::compileHelper(
-    std::string separator,
-    bool indefiniteArticle,
-    casing capitalization) const
+  void token::compile(std::string& output) const
   {
-    switch (type_)
-    {
-      case type::word:
-      {
-        const word_type& w = std::get<word_type>(variant_);
+    output.clear();
 
-        const form& wordForm = w.value.getInflections(w.category).front();
+    compileHelper(output, " ", false, casing::normal);
+  }
 
-        std::string result = wordForm.getText();
+  namespace {
 
-        if (indefiniteArticle)
+    void applyCasing(
+      std::string& output,
+      size_t start,
+      token::casing capitalization)
+    {
+      switch (capitalization)
+      {
+        case token::casing::normal:
         {
-          if (wordForm.startsWithVowelSound())
-          {
-            result = "an " + result;
-          } else {
-            result = "a " + result;
-          }
+          break;
         }
 
-        if (capitalization == casing::capitalize)
+        case token::casing::capitalize:
         {
-          if (std::isalpha(result[0]))
+          if ((start < output.size()) && std::isalpha(output[start]))
           {
-            result[0] = std::toupper(result[0]);
+            output[start] = std::toupper(output[start]);
           }
-        } else if (capitalization == casing::title_case)
-        {
-          std::list<std::string> swords =
-            hatkirby::split<std::list<std::string>>(result, " ");
 
-          for (std::string& sword : swords)
+          break;
+        }
+
+        case token::casing::title_case:
+        {
+          for (size_t i = start; i < output.size(); i++)
           {
-            if (std::isalpha(sword[0]))
+            if (((i == start) || (output[i - 1] == ' '))
+              && std::isalpha(output[i]))
             {
-              sword[0] = std::toupper(sword[0]);
+              output[i] = std::toupper(output[i]);
             }
           }
 
-          result = hatkirby::implode(std::begin(swords), std::end(swords), " ");
-        } else if (capitalization == casing::all_caps)
+          break;
+        }
+
+        case token::casing::all_caps:
         {
-          for (char& ch : result)
+          for (size_t i = start; i < output.size(); i++)
           {
-            if (std::isalpha(ch))
+            if (std::isalpha(output[i]))
             {
-              ch = std::toupper(ch);
+              output[i] = std::toupper(output[i]);
             }
           }
+
+          break;
         }
+      }
+    }
 
-        return result;
+  };
+
+  void token::compileWord(
+    std::string& output,
+    const word& value,
+    inflection category,
+    bool indefiniteArticle,
+    casing capitalization)
+  {
+    const form& wordForm = value.getInflections(category).front();
+
+    size_t start = output.size();
+
+    if (indefiniteArticle)
+    {
+      if (wordForm.startsWithVowelSound())
+      {
+        output += "an ";
+      } else {
+        output += "a ";
       }
+    }
 
-      case type::literal:
+    output += wordForm.getText();
+
+    applyCasing(output, start, capitalization);
+  }
+
+  void token::compileLiteral(
+    std::string& output,
+    const std::string& text,
+    bool indefiniteArticle,
+    casing capitalization)
+  {
+    size_t start = output.size();
+
+    if (indefiniteArticle && std::isalpha(text[0]))
+    {
+      char canon = std::tolower(text[0]);
+      if ((canon == 'a') || (canon == 'e') || (canon == 'i')
+        || (canon == 'o') || (canon == 'u'))
       {
-        std::string result = std::get<literal_type>(variant_);
+        output += "an ";
+      } else {
+        output += "a ";
+      }
+    }
 
-        if (indefiniteArticle && std::isalpha(result[0]))
-        {
-          char canon = std::tolower(result[0]);
-          if ((canon == 'a') || (canon == 'e') || (canon == 'i')
-            || (canon == 'o') || (canon == 'u'))
-          {
-            result = "an " + result;
-          } else {
-            result = "a " + result;
-          }
-        }
+    output += text;
 
-        if (capitalization == casing::capitalize)
-        {
-          if (std::isalpha(result[0]))
-          {
-            result[0] = std::toupper(result[0]);
-          }
-        } else if (capitalization == casing::title_case)
-        {
-          std::list<std::string> swords =
-            hatkirby::split<std::list<std::string>>(result, " ");
+    applyCasing(output, start, capitalization);
+  }
 
-          for (std::string& sword : swords)
-          {
-            if (std::isalpha(sword[0]))
-            {
-              sword[0] = std::toupper(sword[0]);
-            }
-          }
+  /**
+   * The compiled text is appended directly to the output buffer. Casing is
+   * applied in place to the text that a word or literal appends, so nothing is
+   * compiled into a temporary string first.
+   */
+  void token::compileHelper(
+    std::string& output,
+    const std::string& separator,
+    bool indefiniteArticle,
+    casing capitalization) const
+  {
+    switch (type_)
+    {
+      case type::word:
+      {
+        const word_type& w = std::get<word_type>(variant_);
 
-          result = hatkirby::implode(std::begin(swords), std::end(swords), " ");
-        } else if (capitalization == casing::all_caps)
-        {
-          for (char& ch : result)
-          {
-            if (std::isalpha(ch))
-            {
-              ch = std::toupper(ch);
-            }
-          }
-        }
+        compileWord(
+          output,
+          w.value,
+          w.category,
+          indefiniteArticle,
+          capitalization);
+
+        break;
+      }
+
+      case type::literal:
+      {
+        compileLiteral(
+          output,
+          std::get<literal_type>(variant_),
+          indefiniteArticle,
+          capitalization);
 
-        return result;
+        break;
       }
 
       case type::part:
@@ -167,7 +211,6 @@ namespace verbly {
         const utterance_type& utterance = std::get<utterance_type>(variant_);
 
         bool first = true;
-        std::list<std::string> compiled;
         for (const token& tkn : utterance)
         {
           casing propagateCasing = capitalization;
@@ -176,18 +219,21 @@ namespace verbly {
             propagateCasing = casing::normal;
           }
 
-          compiled.push_back(
-            tkn.compileHelper(" ",
-              first && indefiniteArticle,
-              propagateCasing));
+          if (!first)
+          {
+            output += separator;
+          }
+
+          tkn.compileHelper(
+            output,
+            " ",
+            first && indefiniteArticle,
+            propagateCasing);
 
           first = false;
         }
 
-        return hatkirby::implode(
-          std::begin(compiled),
-          std::end(compiled),
-          separator);
+        break;
       }
 
       case type::transform:
@@ -198,46 +244,67 @@ namespace verbly {
         {
           case transform_mode::separator:
           {
-            return transform.inner->compileHelper(
+            transform.inner->compileHelper(
+              output,
               transform.strParam,
               indefiniteArticle,
               capitalization);
+
+            break;
           }
 
           case transform_mode::punctuation:
           {
-            return transform.inner->compileHelper(
+            transform.inner->compileHelper(
+              output,
               separator,
               indefiniteArticle,
-              capitalization) + transform.strParam;
+              capitalization);
+
+            output += transform.strParam;
+
+            break;
           }
 
           case transform_mode::indefinite_article:
           {
-            return transform.inner->compileHelper(
+            transform.inner->compileHelper(
+              output,
               separator,
               true,
               capitalization);
+
+            break;
           }
 
           case transform_mode::capitalize:
           {
-            return transform.inner->compileHelper(
+            transform.inner->compileHelper(
+              output,
               separator,
               indefiniteArticle,
               transform.casingParam);
+
+            break;
           }
 
           case transform_mode::quote:
           {
-            return transform.strParam +
-              transform.inner->compileHelper(
-                separator,
-                indefiniteArticle,
-                capitalization) +
-              transform.strParam2;
+            output += transform.strParam;
+
+            transform.inner->compileHelper(
+              output,
+              separator,
+              indefiniteArticle,
+              capitalization);
+
+            output += transform.strParam2;
+
+            break;
           }
         }
+
+        break;
       }
     }
   }
@@ -314,13 +381,13 @@ namespace verbly {
   }
 
   token::token(
-    std::set<std::string> synrestrs) :
+    restriction_set synrestrs) :
       type_(type::fillin),
-      variant_(std::move(synrestrs))
+      variant_(synrestrs)
   {
   }
 
-  const std::set<std::string>& token::getSynrestrs() const
+  restriction_set token::getSynrestrs() const
   {
     if (type_ != type::fillin)
     {
@@ -330,25 +397,24 @@ namespace verbly {
     return std::get<fillin_type>(variant_);
   }
 
-  bool token::hasSynrestr(std::string synrestr) const
+  bool token::hasSynrestr(restriction_set synrestr) const
   {
     if (type_ != type::fillin)
     {
       throw std::domain_error("Token is not a fillin");
     }
 
-    return std::get<fillin_type>(variant_).count(synrestr);
+    return (std::get<fillin_type>(variant_) & synrestr).any();
   }
 
-  void token::addSynrestr(std::string synrestr)
+  void token::addSynrestr(restriction_set synrestr)
   {
     if (type_ != type::fillin)
     {
       throw std::domain_error("Token is not a fillin");
     }
 
-    fillin_type& fillin = std::get<fillin_type>(variant_);
-    fillin.insert(std::move(synrestr));
+    std::get<fillin_type>(variant_) |= synrestr;
   }
 
   token::token() :
@@ -4,12 +4,12 @@
 #include <ostream>
 #include <string>
 #include <list>
-#include <set>
 #include <variant>
 #include <hkutil/recptr.h>
 #include "enums.h"
 #include "word.h"
 #include "part.h"
+#include "restriction.h"
 
 namespace verbly {
 
@@ -35,6 +35,10 @@ namespace verbly {
 
       std::string compile() const;
 
+      // Compiles the token into the given buffer, replacing its contents but
+      // keeping its capacity, so that a buffer can be reused across calls.
+      void compile(std::string& output) const;
+
       bool isEmpty() const
       {
         return (type_ == type::utterance &&
@@ -64,13 +68,13 @@ namespace verbly {
 
       // Fillin
 
-      token(std::set<std::string> synrestrs);
+      token(restriction_set synrestrs);
 
-      const std::set<std::string>& getSynrestrs() const;
+      restriction_set getSynrestrs() const;
 
-      bool hasSynrestr(std::string synrestr) const;
+      bool hasSynrestr(restriction_set synrestr) const;
 
-      void addSynrestr(std::string synrestr);
+      void addSynrestr(restriction_set synrestr);
 
       // Utterance
 
@@ -109,8 +113,24 @@ namespace verbly {
 
     private:
 
-      std::string compileHelper(
-        std::string separator,
+      friend class token_tree;
+
+      static void compileWord(
+        std::string& output,
+        const word& value,
+        inflection category,
+        bool indefiniteArticle,
+        casing capitalization);
+
+      static void compileLiteral(
+        std::string& output,
+        const std::string& text,
+        bool indefiniteArticle,
+        casing capitalization);
+
+      void compileHelper(
+        std::string& output,
+        const std::string& separator,
         bool indefiniteArticle,
         casing capitalization) const;
 
@@ -140,7 +160,7 @@ namespace verbly {
 
       using literal_type = std::string;
 
-      using fillin_type = std::set<std::string>;
+      using fillin_type = restriction_set;
 
       using utterance_type = std::list<token>;
 
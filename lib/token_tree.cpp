@@ -0,0 +1,680 @@
+#include "token_tree.h"
+#include <stdexcept>
+#include <algorithm>
+
+namespace verbly {
+
+  token_tree::token_tree(const token& root) :
+    token_tree(builder().append(root).build())
+  {
+  }
+
+  token_tree::builder::builder(
+    std::vector<node> nodes,
+    size_t root) :
+      nodes_(std::move(nodes)),
+      root_(root)
+  {
+    open_.push_back(frame { { token::type::utterance, utterance_type {} }, {} });
+  }
+
+  token_tree::builder& token_tree::builder::appendWord(
+    word arg,
+    inflection category)
+  {
+    push(node { token::type::word, word_type { std::move(arg), category } });
+
+    return *this;
+  }
+
+  token_tree::builder& token_tree::builder::appendLiteral(std::string arg)
+  {
+    push(node { token::type::literal, std::move(arg) });
+
+    return *this;
+  }
+
+  token_tree::builder& token_tree::builder::appendPart(part arg)
+  {
+    push(node { token::type::part, std::move(arg) });
+
+    return *this;
+  }
+
+  token_tree::builder& token_tree::builder::appendFillin(
+    restriction_set synrestrs)
+  {
+    push(node { token::type::fillin, synrestrs });
+
+    return *this;
+  }
+
+  token_tree::builder& token_tree::builder::append(const token& arg)
+  {
+    switch (arg.type_)
+    {
+      case token::type::word:
+      {
+        const token::word_type& w = std::get<token::word_type>(arg.variant_);
+
+        return appendWord(w.value, w.category);
+      }
+
+      case token::type::literal:
+      {
+        return appendLiteral(std::get<token::literal_type>(arg.variant_));
+      }
+
+      case token::type::part:
+      {
+        return appendPart(std::get<part>(arg.variant_));
+      }
+
+      case token::type::fillin:
+      {
+        return appendFillin(std::get<token::fillin_type>(arg.variant_));
+      }
+
+      case token::type::utterance:
+      {
+        beginUtterance();
+
+        for (const token& tkn : std::get<token::utterance_type>(arg.variant_))
+        {
+          append(tkn);
+        }
+
+        return endUtterance();
+      }
+
+      case token::type::transform:
+      {
+        const token::transform_type& transform =
+          std::get<token::transform_type>(arg.variant_);
+
+        beginTransform(
+          transform.type,
+          transform.strParam,
+          transform.strParam2,
+          transform.casingParam);
+
+        append(*transform.inner);
+
+        return endTransform();
+      }
+    }
+
+    throw std::logic_error("Invalid token type");
+  }
+
+  token_tree::builder& token_tree::builder::beginUtterance()
+  {
+    open_.push_back(frame { { token::type::utterance, utterance_type {} }, {} });
+
+    return *this;
+  }
+
+  token_tree::builder& token_tree::builder::endUtterance()
+  {
+    if ((open_.size() < 2)
+      || (open_.back().parent.type != token::type::utterance))
+    {
+      throw std::logic_error("No utterance is open");
+    }
+
+    close();
+
+    return *this;
+  }
+
+  token_tree::builder& token_tree::builder::beginSeparator(std::string param)
+  {
+    return beginTransform(
+      token::transform_mode::separator,
+      std::move(param),
+      "",
+      token::casing::normal);
+  }
+
+  token_tree::builder& token_tree::builder::beginPunctuation(std::string param)
+  {
+    return beginTransform(
+      token::transform_mode::punctuation,
+      std::move(param),
+      "",
+      token::casing::normal);
+  }
+
+  token_tree::builder& token_tree::builder::beginIndefiniteArticle()
+  {
+    return beginTransform(
+      token::transform_mode::indefinite_article,
+      "",
+      "",
+      token::casing::normal);
+  }
+
+  token_tree::builder& token_tree::builder::beginCapitalize(
+    token::casing param)
+  {
+    return beginTransform(token::transform_mode::capitalize, "", "", param);
+  }
+
+  token_tree::builder& token_tree::builder::beginQuote(
+    std::string open,
+    std::string close)
+  {
+    return beginTransform(
+      token::transform_mode::quote,
+      std::move(open),
+      std::move(close),
+      token::casing::normal);
+  }
+
+  token_tree::builder& token_tree::builder::endTransform()
+  {
+    if (open_.back().parent.type != token::type::transform)
+    {
+      throw std::logic_error("No transform is open");
+    }
+
+    if (open_.back().children.size() != 1)
+    {
+      throw std::logic_error("Transform must contain exactly one token");
+    }
+
+    close();
+
+    return *this;
+  }
+
+  token_tree token_tree::builder::build()
+  {
+    return token_tree(finish());
+  }
+
+  token_tree::builder& token_tree::builder::beginTransform(
+    token::transform_mode type,
+    std::string param1,
+    std::string param2,
+    token::casing param)
+  {
+    open_.push_back(frame {
+      {
+        token::type::transform,
+        transform_type {
+          type,
+          std::move(param1),
+          std::move(param2),
+          param,
+          0
+        }
+      },
+      {}
+    });
+
+    return *this;
+  }
+
+  void token_tree::builder::push(node arg)
+  {
+    frame& top = open_.back();
+
+    if ((top.parent.type == token::type::transform) && !top.children.empty())
+    {
+      throw std::logic_error("Transform already contains a token");
+    }
+
+    top.children.push_back(std::move(arg));
+  }
+
+  /**
+   * The descendants of the children were appended when the children were
+   * closed, so appending the children themselves now keeps them contiguous.
+   */
+  void token_tree::builder::close()
+  {
+    frame top = std::move(open_.back());
+    open_.pop_back();
+
+    size_t first = nodes_.size();
+
+    for (node& child : top.children)
+    {
+      nodes_.push_back(std::move(child));
+    }
+
+    if (top.parent.type == token::type::utterance)
+    {
+      top.parent.data = utterance_type { first, top.children.size() };
+    } else {
+      std::get<transform_type>(top.parent.data).inner = first;
+    }
+
+    push(std::move(top.parent));
+  }
+
+  std::vector<token_tree::node> token_tree::builder::finish()
+  {
+    if (open_.size() != 1)
+    {
+      throw std::logic_error("Token tree has an open utterance or transform");
+    }
+
+    frame& top = open_.back();
+
+    if (top.children.size() == 1)
+    {
+      nodes_[root_] = std::move(top.children.front());
+    } else {
+      size_t first = nodes_.size();
+
+      for (node& child : top.children)
+      {
+        nodes_.push_back(std::move(child));
+      }
+
+      nodes_[root_] = node {
+        token::type::utterance,
+        utterance_type { first, top.children.size() }
+      };
+    }
+
+    open_.clear();
+
+    return std::move(nodes_);
+  }
+
+  token token_tree::toToken() const
+  {
+    return toTokenHelper(0);
+  }
+
+  token token_tree::toTokenHelper(size_t index) const
+  {
+    const node& n = nodes_[index];
+
+    switch (n.type)
+    {
+      case token::type::word:
+      {
+        const word_type& w = std::get<word_type>(n.data);
+
+        return token(w.value, w.category);
+      }
+
+      case token::type::literal:
+      {
+        return token(std::get<std::string>(n.data));
+      }
+
+      case token::type::part:
+      {
+        return token(std::get<part>(n.data));
+      }
+
+      case token::type::fillin:
+      {
+        return token(std::get<restriction_set>(n.data));
+      }
+
+      case token::type::utterance:
+      {
+        const utterance_type& utterance = std::get<utterance_type>(n.data);
+
+        token result;
+
+        for (size_t i = 0; i < utterance.count; i++)
+        {
+          result << toTokenHelper(utterance.first + i);
+        }
+
+        return result;
+      }
+
+      case token::type::transform:
+      {
+        const transform_type& transform = std::get<transform_type>(n.data);
+
+        if (transform.type == token::transform_mode::capitalize)
+        {
+          return token(
+            transform.type,
+            transform.casingParam,
+            toTokenHelper(transform.inner));
+        } else {
+          return token(
+            transform.type,
+            transform.strParam,
+            transform.strParam2,
+            toTokenHelper(transform.inner));
+        }
+      }
+    }
+
+    throw std::logic_error("Invalid token type");
+  }
+
+  const word& token_tree::getWord(size_t index) const
+  {
+    if (getType(index) != token::type::word)
+    {
+      throw std::domain_error("Node is not a word");
+    }
+
+    return std::get<word_type>(nodes_[index].data).value;
+  }
+
+  inflection token_tree::getInflection(size_t index) const
+  {
+    if (getType(index) != token::type::word)
+    {
+      throw std::domain_error("Node is not a word");
+    }
+
+    return std::get<word_type>(nodes_[index].data).category;
+  }
+
+  const std::string& token_tree::getLiteral(size_t index) const
+  {
+    if (getType(index) != token::type::literal)
+    {
+      throw std::domain_error("Node is not a literal");
+    }
+
+    return std::get<std::string>(nodes_[index].data);
+  }
+
+  const part& token_tree::getPart(size_t index) const
+  {
+    if (getType(index) != token::type::part)
+    {
+      throw std::domain_error("Node is not a part");
+    }
+
+    return std::get<part>(nodes_[index].data);
+  }
+
+  restriction_set token_tree::getSynrestrs(size_t index) const
+  {
+    if (getType(index) != token::type::fillin)
+    {
+      throw std::domain_error("Node is not a fillin");
+    }
+
+    return std::get<restriction_set>(nodes_[index].data);
+  }
+
+  size_t token_tree::getChildCount(size_t index) const
+  {
+    switch (getType(index))
+    {
+      case token::type::utterance:
+      {
+        return std::get<utterance_type>(nodes_[index].data).count;
+      }
+
+      case token::type::transform:
+      {
+        return 1;
+      }
+
+      case token::type::word:
+      case token::type::literal:
+      case token::type::part:
+      case token::type::fillin:
+      {
+        return 0;
+      }
+    }
+
+    throw std::logic_error("Invalid token type");
+  }
+
+  size_t token_tree::getChild(size_t index, size_t n) const
+  {
+    if (n >= getChildCount(index))
+    {
+      throw std::out_of_range("Node does not have that many children");
+    }
+
+    if (getType(index) == token::type::utterance)
+    {
+      return std::get<utterance_type>(nodes_[index].data).first + n;
+    } else {
+      return std::get<transform_type>(nodes_[index].data).inner;
+    }
+  }
+
+  /**
+   * Every node in the vector is reachable from the root, so the tree is
+   * complete exactly when none of its nodes are parts or fillins.
+   */
+  bool token_tree::isComplete() const
+  {
+    return std::none_of(
+      std::begin(nodes_),
+      std::end(nodes_),
+      [] (const node& n) {
+        return (n.type == token::type::part)
+          || (n.type == token::type::fillin);
+      });
+  }
+
+  std::string token_tree::compile() const
+  {
+    std::string result;
+    compile(result);
+
+    return result;
+  }
+
+  void token_tree::compile(std::string& output) const
+  {
+    output.clear();
+
+    compileHelper(0, output, " ", false, token::casing::normal);
+  }
+
+  void token_tree::compileHelper(
+    size_t index,
+    std::string& output,
+    const std::string& separator,
+    bool indefiniteArticle,
+    token::casing capitalization) const
+  {
+    const node& n = nodes_[index];
+
+    switch (n.type)
+    {
+      case token::type::word:
+      {
+        const word_type& w = std::get<word_type>(n.data);
+
+        token::compileWord(
+          output,
+          w.value,
+          w.category,
+          indefiniteArticle,
+          capitalization);
+
+        break;
+      }
+
+      case token::type::literal:
+      {
+        token::compileLiteral(
+          output,
+          std::get<std::string>(n.data),
+          indefiniteArticle,
+          capitalization);
+
+        break;
+      }
+
+      case token::type::part:
+      case token::type::fillin:
+      {
+        throw std::domain_error("Cannot compile incomplete token");
+      }
+
+      case token::type::utterance:
+      {
+        const utterance_type& utterance = std::get<utterance_type>(n.data);
+
+        for (size_t i = 0; i < utterance.count; i++)
+        {
+          token::casing propagateCasing = capitalization;
+          if ((capitalization == token::casing::capitalize) && (i > 0))
+          {
+            propagateCasing = token::casing::normal;
+          }
+
+          if (i > 0)
+          {
+            output += separator;
+          }
+
+          compileHelper(
+            utterance.first + i,
+            output,
+            " ",
+            (i == 0) && indefiniteArticle,
+            propagateCasing);
+        }
+
+        break;
+      }
+
+      case token::type::transform:
+      {
+        const transform_type& transform = std::get<transform_type>(n.data);
+
+        switch (transform.type)
+        {
+          case token::transform_mode::separator:
+          {
+            compileHelper(
+              transform.inner,
+              output,
+              transform.strParam,
+              indefiniteArticle,
+              capitalization);
+
+            break;
+          }
+
+          case token::transform_mode::punctuation:
+          {
+            compileHelper(
+              transform.inner,
+              output,
+              separator,
+              indefiniteArticle,
+              capitalization);
+
+            output += transform.strParam;
+
+            break;
+          }
+
+          case token::transform_mode::indefinite_article:
+          {
+            compileHelper(
+              transform.inner,
+              output,
+              separator,
+              true,
+              capitalization);
+
+            break;
+          }
+
+          case token::transform_mode::capitalize:
+          {
+            compileHelper(
+              transform.inner,
+              output,
+              separator,
+              indefiniteArticle,
+              transform.casingParam);
+
+            break;
+          }
+
+          case token::transform_mode::quote:
+          {
+            output += transform.strParam;
+
+            compileHelper(
+              transform.inner,
+              output,
+              separator,
+              indefiniteArticle,
+              capitalization);
+
+            output += transform.strParam2;
+
+            break;
+          }
+        }
+
+        break;
+      }
+    }
+  }
+
+  std::vector<size_t> token_tree::getIncomplete() const
+  {
+    std::vector<size_t> result;
+    getIncompleteHelper(0, result);
+
+    return result;
+  }
+
+  void token_tree::getIncompleteHelper(
+    size_t index,
+    std::vector<size_t>& result) const
+  {
+    switch (nodes_[index].type)
+    {
+      case token::type::part:
+      case token::type::fillin:
+      {
+        result.push_back(index);
+
+        break;
+      }
+
+      case token::type::utterance:
+      case token::type::transform:
+      {
+        for (size_t i = 0; i < getChildCount(index); i++)
+        {
+          getIncompleteHelper(getChild(index, i), result);
+        }
+
+        break;
+      }
+
+      case token::type::word:
+      case token::type::literal:
+      {
+        break;
+      }
+    }
+  }
+
+  void token_tree::fill(size_t index, const token& replacement)
+  {
+    token::type current = getType(index);
+
+    if ((current != token::type::part) && (current != token::type::fillin))
+    {
+      throw std::domain_error("Only parts and fillins can be filled in");
+    }
+
+    nodes_ = builder(std::move(nodes_), index).append(replacement).finish();
+  }
+
+};
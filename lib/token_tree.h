@@ -0,0 +1,222 @@
+#ifndef TOKEN_TREE_H_E647689B
+#define TOKEN_TREE_H_E647689B
+
+#include <string>
+#include <vector>
+#include <variant>
+#include "token.h"
+
+namespace verbly {
+
+  /**
+   * A compact representation of a token, in which every node of the tree is
+   * stored in one contiguous vector and refers to its children by index. The
+   * children of a node are always stored next to each other. This makes it
+   * cheaper to compile, check, and fill in large utterances than it is to walk
+   * the linked structure of a token.
+   *
+   * Nodes are identified by their index, and the root is always node zero.
+   *
+   * Nothing in the library builds or uses a token_tree itself. It is there
+   * for callers that compile or fill in the same large utterance many times,
+   * which can convert their token once, or build the tree directly with a
+   * builder, and convert it back with toToken() when they are done.
+   */
+  class token_tree {
+  public:
+
+    // Constructors
+
+    token_tree() : token_tree(token())
+    {
+    }
+
+    explicit token_tree(const token& root);
+
+    class builder;
+
+    // Conversion
+
+    token toToken() const;
+
+    // Accessors
+
+    size_t size() const
+    {
+      return nodes_.size();
+    }
+
+    token::type getType(size_t index) const
+    {
+      return nodes_.at(index).type;
+    }
+
+    const word& getWord(size_t index) const;
+
+    inflection getInflection(size_t index) const;
+
+    const std::string& getLiteral(size_t index) const;
+
+    const part& getPart(size_t index) const;
+
+    restriction_set getSynrestrs(size_t index) const;
+
+    // Returns the number of children of an utterance or transform node.
+    size_t getChildCount(size_t index) const;
+
+    // Returns the index of the nth child of an utterance or transform node.
+    size_t getChild(size_t index, size_t n) const;
+
+    // Compiling
+
+    bool isComplete() const;
+
+    std::string compile() const;
+
+    void compile(std::string& output) const;
+
+    // Filling in
+
+    /**
+     * Returns the indices of the part and fillin nodes in the tree, in the
+     * order in which they appear in the utterance.
+     */
+    std::vector<size_t> getIncomplete() const;
+
+    /**
+     * Replaces a part or fillin node with the given token. If the replacement
+     * has children, they are appended to the end of the tree, so the indices
+     * of the existing nodes stay the same.
+     */
+    void fill(size_t index, const token& replacement);
+
+  private:
+
+    struct word_type {
+      word value;
+      inflection category;
+    };
+
+    struct utterance_type {
+      size_t first;
+      size_t count;
+    };
+
+    struct transform_type {
+      token::transform_mode type;
+      std::string strParam;
+      std::string strParam2;
+      token::casing casingParam;
+      size_t inner;
+    };
+
+    struct node {
+      token::type type;
+
+      std::variant<
+        word_type,
+        std::string,
+        part,
+        restriction_set,
+        utterance_type,
+        transform_type> data;
+    };
+
+    explicit token_tree(std::vector<node> nodes) : nodes_(std::move(nodes))
+    {
+    }
+
+    token toTokenHelper(size_t index) const;
+
+    void compileHelper(
+      size_t index,
+      std::string& output,
+      const std::string& separator,
+      bool indefiniteArticle,
+      token::casing capitalization) const;
+
+    void getIncompleteHelper(
+      size_t index,
+      std::vector<size_t>& result) const;
+
+    std::vector<node> nodes_;
+  };
+
+  /**
+   * Builds a token tree directly into its node vector, without building a
+   * token first. Words, literals, parts, and fillins are appended to the
+   * innermost open utterance or transform. The children of an open node are
+   * held back until it is closed, and are then appended to the vector next to
+   * each other.
+   *
+   * If more than one node is appended at the top level, the root of the tree
+   * is an utterance containing them.
+   */
+  class token_tree::builder {
+  public:
+
+    builder() : builder({ node {} }, 0)
+    {
+    }
+
+    builder& appendWord(word arg, inflection category = inflection::base);
+
+    builder& appendLiteral(std::string arg);
+
+    builder& appendPart(part arg);
+
+    builder& appendFillin(restriction_set synrestrs);
+
+    // Appends a copy of an existing token.
+    builder& append(const token& arg);
+
+    builder& beginUtterance();
+
+    builder& endUtterance();
+
+    builder& beginSeparator(std::string param);
+
+    builder& beginPunctuation(std::string param);
+
+    builder& beginIndefiniteArticle();
+
+    builder& beginCapitalize(token::casing param);
+
+    builder& beginQuote(std::string open, std::string close);
+
+    // Closes a transform, which must contain exactly one token.
+    builder& endTransform();
+
+    token_tree build();
+
+  private:
+
+    friend class token_tree;
+
+    struct frame {
+      node parent;
+      std::vector<node> children;
+    };
+
+    builder(std::vector<node> nodes, size_t root);
+
+    builder& beginTransform(
+      token::transform_mode type,
+      std::string param1,
+      std::string param2,
+      token::casing param);
+
+    void push(node arg);
+
+    void close();
+
+    std::vector<node> finish();
+
+    std::vector<node> nodes_;
+    size_t root_;
+    std::vector<frame> open_;
+  };
+
+};
+
+#endif /* end of include guard: TOKEN_TREE_H_E647689B */
@@ -13,5 +13,6 @@
 #include "form.h"
 #include "pronunciation.h"
 #include "token.h"
+#include "token_tree.h"
 
 #endif /* end of include guard: VERBLY_H_5B39CE50 */
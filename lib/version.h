@@ -3,8 +3,8 @@
 
 namespace verbly {
 
-  const int DATABASE_MAJOR_VERSION = 1;
-  const int DATABASE_MINOR_VERSION = 1;
+  const int DATABASE_MAJOR_VERSION = 2;
+  const int DATABASE_MINOR_VERSION = 0;
 
 };
 
@@ -43,42 +43,83 @@ namespace verbly {
     return field::joinThroughWhere(object::word, "lemma_id", object::form, "lemmas_forms", "form_id", "category", static_cast<int>(category));
   }
 
-  word::word(const database& db, hatkirby::row row) : db_(&db), valid_(true)
+  word::word(const database& db, const cursor& columns)
   {
-    id_ = std::get<int>(row[0]);
+    std::shared_ptr<state_type> state = std::make_shared<state_type>();
 
-    notion_ = db.notions(notion::id == std::get<int>(row[1])).first();
+    state->db = &db;
+    state->id = columns.getInteger(0);
+    state->lemmaId = columns.getInteger(2);
 
-    if (!std::holds_alternative<std::nullptr_t>(row[3]))
+    state->notion = db.getNotion(columns.getInteger(1));
+
+    if (!columns.isNull(3))
     {
-      hasTagCount_ = true;
-      tagCount_ = std::get<int>(row[3]);
+      state->hasTagCount = true;
+      state->tagCount = columns.getInteger(3);
     }
 
-    if (!std::holds_alternative<std::nullptr_t>(row[4]))
+    if (!columns.isNull(4))
     {
-      adjectivePosition_ = static_cast<positioning>(std::get<int>(row[4]));
+      state->adjectivePosition = static_cast<positioning>(columns.getInteger(4));
     }
 
-    if (!std::holds_alternative<std::nullptr_t>(row[5]))
+    if (!columns.isNull(5))
     {
-      frames_ = db.frames(*this).all();
+      state->hasGroup = true;
+      state->groupId = columns.getInteger(5);
     }
+
+    state_ = std::move(state);
   }
 
-  const form& word::getBaseForm() const
+  bool word::hasFrames() const
+  {
+    return !getFrames().empty();
+  }
+
+  /**
+   * The frames are owned by the database's frame catalog, which is loaded the
+   * first time any word's frames are requested.
+   */
+  const std::vector<frame>& word::getFrames() const
   {
-    if (!valid_)
+    if (!state_)
     {
       throw std::domain_error("Bad access to uninitialized word");
     }
 
-    if (!forms_.count(inflection::base))
+    static const std::vector<frame> noFrames;
+
+    if (!state_->hasGroup)
+    {
+      return noFrames;
+    }
+
+    if (!state_->db)
     {
-      initializeForm(inflection::base);
+      throw std::domain_error("Database not present");
+    }
+
+    std::shared_ptr<const std::vector<frame>> groupFrames =
+      state_->db->getGroupFrames(state_->groupId);
+
+    if (!groupFrames)
+    {
+      return noFrames;
     }
 
-    return forms_.at(inflection::base).front();
+    return *groupFrames;
+  }
+
+  const form& word::getBaseForm() const
+  {
+    if (!state_)
+    {
+      throw std::domain_error("Bad access to uninitialized word");
+    }
+
+    return loadForms(inflection::base).front();
   }
 
   bool word::hasInflection(inflection category) const
@@ -88,27 +129,78 @@ namespace verbly {
 
   const std::vector<form>& word::getInflections(inflection category) const
   {
-    if (!valid_)
+    if (!state_)
     {
       throw std::domain_error("Bad access to uninitialized word");
     }
 
-    if (!forms_.count(category))
-    {
-      initializeForm(category);
-    }
+    return loadForms(category);
+  }
+
+  const std::vector<form>& word::loadForms(inflection category) const
+  {
+    size_t slot = static_cast<size_t>(category);
+
+    form_cache& cache = state_->forms;
+
+    std::call_once(cache.initialized[slot], [&] () {
+      if (!state_->db)
+      {
+        throw std::domain_error("Database not present");
+      }
 
-    return forms_.at(category);
+      cache.forms[slot] = state_->db->forms(form::words(category) %= *this, verbly::form::id, -1).all();
+    });
+
+    return cache.forms[slot];
   }
 
-  void word::initializeForm(inflection infl) const
+  void word::prefetchInflections(
+    const database& db,
+    std::vector<word>& words,
+    const std::set<inflection>& categories)
   {
-    if (!db_)
+    std::set<int> lemmaIds;
+
+    for (const word& w : words)
     {
-      throw std::domain_error("Database not present");
+      if (w.state_)
+      {
+        lemmaIds.insert(w.state_->lemmaId);
+      }
     }
 
-    forms_[infl] = db_->forms(form::words(infl) %= *this, verbly::form::id, -1).all();
+    if (lemmaIds.empty() || categories.empty())
+    {
+      return;
+    }
+
+    std::map<std::tuple<int, inflection>, std::vector<form>> lemmaForms =
+      db.getLemmaForms(lemmaIds, categories);
+
+    for (word& w : words)
+    {
+      if (!w.state_)
+      {
+        continue;
+      }
+
+      for (inflection category : categories)
+      {
+        auto key = std::make_tuple(w.state_->lemmaId, category);
+        size_t slot = static_cast<size_t>(category);
+        form_cache& cache = w.state_->forms;
+
+        // Inflections that have already been loaded are left alone, since
+        // other threads may be reading them.
+        std::call_once(cache.initialized[slot], [&] () {
+          if (lemmaForms.count(key))
+          {
+            cache.forms[slot] = lemmaForms.at(key);
+          }
+        });
+      }
+    }
   }
 
   filter word::synonyms_field::operator%=(filter joinCondition) const
@@ -2,9 +2,14 @@
 #define WORD_H_DF91B1B4
 
 #include <stdexcept>
-#include <map>
+#include <array>
+#include <set>
+#include <vector>
+#include <memory>
+#include <mutex>
 #include <hkutil/database.h>
 #include "field.h"
+#include "connection.h"
 #include "filter.h"
 #include "notion.h"
 #include "frame.h"
@@ -23,104 +28,88 @@ namespace verbly {
 
     // Construct from database
 
-    word(const database& db, hatkirby::row row);
+    word(const database& db, const cursor& columns);
 
     // Accessors
 
     bool isValid() const
     {
-      return valid_;
+      return (state_ != nullptr);
     }
 
     int getId() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized word");
       }
 
-      return id_;
+      return state_->id;
     }
 
     bool hasTagCount() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized word");
       }
 
-      return hasTagCount_;
+      return state_->hasTagCount;
     }
 
     int getTagCount() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized word");
       }
 
-      if (!hasTagCount_)
+      if (!state_->hasTagCount)
       {
         throw std::domain_error("Word has no tag count");
       }
 
-      return tagCount_;
+      return state_->tagCount;
     }
 
     bool hasAdjectivePositioning() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized word");
       }
 
-      return (adjectivePosition_ != positioning::undefined);
+      return (state_->adjectivePosition != positioning::undefined);
     }
 
     positioning getAdjectivePosition() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized word");
       }
 
-      if (adjectivePosition_ == positioning::undefined)
+      if (state_->adjectivePosition == positioning::undefined)
       {
         throw std::domain_error("Word has no adjective position");
       }
 
-      return adjectivePosition_;
+      return state_->adjectivePosition;
     }
 
     const notion& getNotion() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized word");
       }
 
-      return notion_;
+      return state_->notion;
     }
 
-    bool hasFrames() const
-    {
-      if (!valid_)
-      {
-        throw std::domain_error("Bad access to uninitialized word");
-      }
-
-      return !frames_.empty();
-    }
-
-    const std::vector<frame>& getFrames() const
-    {
-      if (!valid_)
-      {
-        throw std::domain_error("Bad access to uninitialized word");
-      }
+    bool hasFrames() const;
 
-      return frames_;
-    }
+    const std::vector<frame>& getFrames() const;
 
     const form& getBaseForm() const;
 
@@ -128,6 +117,18 @@ namespace verbly {
 
     const std::vector<form>& getInflections(inflection category) const;
 
+    // Prefetching
+
+    /**
+     * Loads the given inflections of every word in the list up front, using
+     * one query per batch of words rather than one query per word and
+     * inflection the first time each inflection is requested.
+     */
+    static void prefetchInflections(
+      const database& db,
+      std::vector<word>& words,
+      const std::set<inflection>& categories);
+
     // Type info
 
     static const object objectType;
@@ -142,22 +143,22 @@ namespace verbly {
 
     operator filter() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized word");
       }
 
-      return (id == id_);
+      return (id == state_->id);
     }
 
     filter operator!() const
     {
-      if (!valid_)
+      if (!state_)
       {
         throw std::domain_error("Bad access to uninitialized word");
       }
 
-      return (id != id_);
+      return (id != state_->id);
     }
 
     // Relationships with other objects
@@ -203,18 +204,37 @@ namespace verbly {
 
   private:
 
-    void initializeForm(inflection category) const;
+    const std::vector<form>& loadForms(inflection category) const;
 
-    bool valid_ = false;
-    int id_;
-    bool hasTagCount_ = false;
-    int tagCount_;
-    positioning adjectivePosition_ = positioning::undefined;
-    notion notion_;
-    std::vector<frame> frames_;
-    mutable std::map<inflection, std::vector<form>> forms_;
+    // The forms of a word are loaded the first time each inflection is
+    // requested. Each inflection has its own slot and once flag, so that words
+    // can be read from several threads at once without a shared lock.
+    // s_form is the last inflection.
+    static constexpr size_t inflectionCount =
+      static_cast<size_t>(inflection::s_form) + 1;
+
+    struct form_cache {
+      std::array<std::once_flag, inflectionCount> initialized;
+      std::array<std::vector<form>, inflectionCount> forms;
+    };
+
+    // A word is a handle to state that is shared between copies, so copying a
+    // word is as cheap as copying a pointer. Apart from the form cache, the
+    // state does not change after the word is read.
+    struct state_type {
+      const database* db = nullptr;
+      int id;
+      int lemmaId;
+      bool hasTagCount = false;
+      int tagCount;
+      positioning adjectivePosition = positioning::undefined;
+      verbly::notion notion;
+      bool hasGroup = false;
+      int groupId;
+      mutable form_cache forms;
+    };
 
-    const database* db_ = nullptr;
+    std::shared_ptr<const state_type> state_;
   };
 
 };